@@ -14,6 +14,14 @@ public:
 
     glm::mat4 getViewMatrix() const;
     glm::vec3 getPosition() const { return Position; }
+    glm::vec3 getFront() const { return Front; }
+    float getYaw() const { return Yaw; }
+    float getPitch() const { return Pitch; }
+
+    // Move the camera directly (e.g. to follow the player)
+    void setPosition(const glm::vec3& position) { Position = position; }
+    // Point the camera directly (e.g. replaying a recorded path)
+    void setOrientation(float yaw, float pitch);
 
     // Handle keyboard input
     void processKeyboard(Movement direction, float deltaTime);
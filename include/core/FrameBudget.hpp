@@ -0,0 +1,102 @@
+#pragma once
+
+// FrameBudget - holds frame times to a target by scaling how much work a frame does
+//
+// Feed it the time every frame took (endFrame()) and apply what it decides:
+//   - render distance, the slow knob. Lowered when the average frame over the
+//     last WINDOW frames runs over the target, raised when even the slow
+//     frames (90th percentile) leave plenty of room and nothing is left
+//     streaming in. Each raise has to hold for a while before the next one,
+//     and a raise that got taken back right away makes the next wait twice as
+//     long, so it settles instead of bouncing between two distances.
+//   - per-frame streaming limits (meshes uploaded, chunks loaded), the fast
+//     knobs. Halved on any frame over the target, grown a little on frames
+//     well under it while there's a backlog (additive increase, multiplicative
+//     decrease). Whatever doesn't fit waits for the next frame.
+//
+// Every change is kept as a BudgetDecision, so callers can log why.
+// Pure bookkeeping, no GL and no clock - the caller measures the frames.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+struct BudgetDecision {
+    uint64_t frame = 0;         // endFrame() count when it was made
+    double meanMs = 0.0;        // over the window it was based on
+    double p90Ms = 0.0;
+    int renderDistance = 0;     // the new settings
+    std::size_t uploadLimit = 0;
+    std::size_t loadLimit = 0;
+    const char* reason = "";
+};
+
+class FrameBudget {
+public:
+    static constexpr std::size_t WINDOW = 60;          // frames the distance decisions look at
+    static constexpr int MIN_DISTANCE = 2;
+    static constexpr std::size_t MIN_UPLOADS = 2, MAX_UPLOADS = 256;
+    static constexpr std::size_t MIN_LOADS = 1, MAX_LOADS = 64;
+    static constexpr uint64_t RAISE_WAIT = 2 * WINDOW;  // frames a distance has to hold before going up
+    static constexpr uint64_t MAX_RAISE_WAIT = 32 * WINDOW;
+
+    // targetMs: 16.6 for 60 fps, 8.3 for 120. Distance starts at startDistance
+    FrameBudget(double targetMs, int startDistance, int maxDistance);
+
+    // One frame's work took frameMs. backlog = meshes and chunks still
+    // waiting because of the limits. Returns true if a setting changed
+    bool endFrame(double frameMs, std::size_t backlog);
+
+    double getTargetMs() const { return m_targetMs; }
+    int getRenderDistance() const { return m_distance; }
+    std::size_t getUploadLimit() const { return m_uploadLimit; }
+    std::size_t getLoadLimit() const { return m_loadLimit; }
+
+    // The most recent change of render distance, and of anything at all
+    const BudgetDecision& getLastDistanceDecision() const { return m_lastDistance; }
+    const BudgetDecision& getLastDecision() const { return m_last; }
+
+private:
+    void decide(const char* reason, bool distanceChanged);
+    double percentile90() const;
+
+    double m_targetMs;
+    int m_distance;
+    int m_maxDistance;
+    std::size_t m_uploadLimit = 32;
+    std::size_t m_loadLimit = 8;
+
+    // Frame times since the last distance change, the last WINDOW of them
+    std::array<double, WINDOW> m_window{};
+    std::size_t m_count = 0;
+    std::size_t m_next = 0;
+
+    uint64_t m_frame = 0;
+    uint64_t m_sinceChange = 0;      // frames at the current distance
+    uint64_t m_raiseWait = RAISE_WAIT;
+    bool m_lastWasRaise = false;
+
+    BudgetDecision m_lastDistance;
+    BudgetDecision m_last;
+};
+
+// Writes BudgetDecisions as CSV lines, one per decision, for tuning the targets
+class BudgetLog {
+public:
+    BudgetLog() = default;
+    ~BudgetLog();
+
+    BudgetLog(const BudgetLog&) = delete;
+    BudgetLog& operator=(const BudgetLog&) = delete;
+
+    // "-" writes to stdout. Prints to stderr and returns false if the file can't be opened
+    bool open(const std::string& path);
+    bool isOpen() const { return m_file != nullptr; }
+
+    void write(const BudgetDecision& decision);
+
+private:
+    std::FILE* m_file = nullptr;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+// Framebuffer - an offscreen render target (RGBA8 color + 24-bit depth)
+// For rendering without a window, or without presenting what's drawn
+
+#include <glad/glad.h>
+#include <cstdint>
+
+class Framebuffer {
+public:
+    Framebuffer() = default;
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    // Needs a current GL context. Prints to stderr and returns false if the
+    // framebuffer isn't complete
+    bool create(int width, int height);
+
+    // Bind for drawing and set the viewport to cover it
+    void bind() const;
+    static void unbind() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+private:
+    void release();
+    int64_t renderbufferBytes() const { return static_cast<int64_t>(m_width) * m_height * 4; }
+
+    GLuint m_fbo = 0;
+    GLuint m_color = 0;
+    GLuint m_depth = 0;
+    int m_width = 0;
+    int m_height = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+// GLStateCache - remembers what's bound and skips binds that change nothing
+// Everything that binds programs, VAOs, array/texture/uniform buffers or the
+// buffer texture has to go through here, or call invalidate() afterwards.
+// Element array buffers are VAO state, bind those directly.
+//
+// Deleting a bound object unbinds it in GL, and its name can come back from
+// the next glGen* call - invalidate() after deleting anything.
+
+#include "core/RenderStats.hpp"
+#include <glad/glad.h>
+
+class GLStateCache {
+public:
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    // GL_ARRAY_BUFFER, GL_TEXTURE_BUFFER or GL_UNIFORM_BUFFER
+    void bindBuffer(GLenum target, GLuint buffer);
+    // GL_TEXTURE_BUFFER on texture unit 0, the only unit in use
+    void bindBufferTexture(GLuint texture);
+
+    // Forget everything, the next bind of each kind always goes to GL
+    void invalidate();
+
+    // Where binds are counted (stateChanges / redundantStateChanges), nullptr for nowhere
+    void setStats(RenderStats* stats) { m_stats = stats; }
+
+private:
+    static constexpr GLuint UNKNOWN = ~0u;
+
+    // True if the bind has to happen, counts it either way
+    bool change(GLuint& current, GLuint wanted);
+
+    GLuint m_program = 0;
+    GLuint m_vao = 0;
+    GLuint m_arrayBuffer = 0;
+    GLuint m_textureBuffer = 0;
+    GLuint m_uniformBuffer = 0;
+    GLuint m_bufferTexture = 0;
+    RenderStats* m_stats = nullptr;
+};
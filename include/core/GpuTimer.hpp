@@ -0,0 +1,41 @@
+#pragma once
+
+// GpuTimer - GPU time of one render pass, via GL_TIME_ELAPSED queries
+// Wrap the pass in begin()/end() every frame. Results arrive a few frames
+// late, so queries go round a small ring and are only read back once the
+// GPU is done with them - reading never stalls the pipeline unless the ring
+// is full. Elapsed queries can't nest: time passes one after another.
+
+#include "core/Stats.hpp"
+#include <glad/glad.h>
+#include <array>
+
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void begin();
+    void end();
+
+    // Wait for every outstanding query and collect its result
+    // Call before reading getSamples() at the end of a run
+    void finish();
+
+    // Milliseconds per begin()/end() pair, in order
+    const SampleStats& getSamples() const { return m_samples; }
+
+private:
+    static constexpr int RING_SIZE = 4;
+
+    // Collect the result of the oldest query, wait for it if wait is set
+    bool collect(bool wait);
+
+    std::array<GLuint, RING_SIZE> m_queries{};
+    int m_next = 0;    // slot the next begin() uses
+    int m_pending = 0; // queries ended but not read back yet
+    SampleStats m_samples;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+// MemoryTracker - live memory and GL resources, by category
+// The owners of the big allocations (Chunk, WorldRenderer, Renderer) report
+// what they allocate and free; snapshot() reads the totals back. Counters
+// are atomics, chunks get created and meshed on the worker threads.
+//
+// Objects are allocations on the CPU side and GL object names on the GPU
+// side, so a count that only ever grows over a long session is a leak.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+enum class MemoryCategory {
+    BLOCKS,      // Chunk block arrays
+    LIGHT,       // Chunk light arrays
+    MESH_CPU,    // chunk meshes built but not uploaded yet (objects), and the upload scratch
+    GPU_BUFFERS, // VBOs/EBOs/buffer textures' storage
+    GL_OBJECTS,  // every other GL object (VAOs, textures, programs, renderbuffers)
+    COUNT
+};
+
+const char* memoryCategoryName(MemoryCategory category);
+
+struct MemoryCounter {
+    int64_t bytes = 0;
+    int64_t peakBytes = 0;
+    int64_t objects = 0;
+    int64_t peakObjects = 0;
+    uint64_t allocations = 0; // objects ever created
+};
+
+struct MemorySnapshot {
+    std::array<MemoryCounter, static_cast<std::size_t>(MemoryCategory::COUNT)> counters;
+
+    const MemoryCounter& operator[](MemoryCategory category) const {
+        return counters[static_cast<std::size_t>(category)];
+    }
+    int64_t totalBytes() const;
+
+    // One line per category
+    void print(std::ostream& out) const;
+};
+
+namespace MemoryTracker {
+    // Record a change: bytes and objects can be negative (frees)
+    // New objects also count towards allocations
+    void add(MemoryCategory category, int64_t bytes, int64_t objects = 0);
+
+    MemorySnapshot snapshot();
+}
+
+// Writes a snapshot every intervalSeconds, as CSV so long sessions can be
+// plotted: seconds, then bytes/peak bytes/objects for every category
+class MemoryLog {
+public:
+    MemoryLog() = default;
+    ~MemoryLog();
+
+    MemoryLog(const MemoryLog&) = delete;
+    MemoryLog& operator=(const MemoryLog&) = delete;
+
+    // "-" writes to stdout. Prints to stderr and returns false if the file can't be opened
+    bool open(const std::string& path, double intervalSeconds = 10.0);
+    bool isOpen() const { return m_file != nullptr; }
+
+    // Call every frame/tick, writes a line once the interval is up
+    void update();
+    // Write a line now
+    void write();
+
+private:
+    std::FILE* m_file = nullptr;
+    double m_interval = 10.0;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_next;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+// OffscreenContext - a GL 3.3 core context with no window or display
+// Uses EGL's surfaceless platform (Mesa), so it works on servers and CI
+// machines with no X/Wayland and no GPU (llvmpipe). There's no default
+// framebuffer: render into a Framebuffer.
+
+#include <glad/glad.h>
+
+class OffscreenContext {
+public:
+    OffscreenContext() = default;
+    ~OffscreenContext();
+
+    OffscreenContext(const OffscreenContext&) = delete;
+    OffscreenContext& operator=(const OffscreenContext&) = delete;
+
+    // Create the context and make it current on this thread
+    // Prints to stderr and returns false on failure
+    bool create();
+
+    // For gladLoadGLLoader / Renderer::init
+    static GLADloadproc getLoader();
+
+private:
+    // EGLDisplay / EGLContext, kept opaque so EGL headers stay out of here
+    void* m_display = nullptr;
+    void* m_context = nullptr;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+// Counters for the GL work a frame does, for comparing render paths
+// Kept by whoever issues the GL calls (see WorldRenderer::getStats())
+
+#include <cstdint>
+
+struct RenderStats {
+    uint64_t drawCalls = 0;
+    uint64_t triangles = 0;
+    uint64_t stateChanges = 0; // program, VAO, buffer and texture binds, uniform uploads
+    uint64_t redundantStateChanges = 0; // binds the GLStateCache skipped
+    uint64_t uploads = 0;      // glBufferData calls
+    uint64_t uploadBytes = 0;
+    uint64_t uploadsDeferred = 0; // pending meshes left for a later frame by the upload limit
+
+    void reset() { *this = RenderStats(); }
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/GLStateCache.hpp"
+#include "world/Chunk.hpp"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <string>
@@ -9,21 +11,42 @@ public:
     Renderer();
     ~Renderer();
 
-    void init(int width, int height);
+    // loader finds GL functions for the current context, e.g. glfwGetProcAddress
+    void init(int width, int height, GLADloadproc loader);
     void clear();
     void drawCube(glm::vec3 position);
+    // Camera matrices live in a uniform buffer every program reads, setting
+    // them is a buffer update rather than a uniform upload per program
     void setViewMatrix(glm::mat4 view);
     void setProjectionMatrix(glm::mat4 projection);
-    
+
+    // Bind the program that draws chunk meshes of this format
+    // FACES: packed faces come from the buffer texture on unit 0, the chunk
+    // position from the uniform at getChunkOriginLocation()
+    void useChunkProgram(MeshFormat format);
+    GLint getChunkOriginLocation() const { return chunkOriginLoc; }
+
     // Get the shader program (useful for external rendering like chunks)
     GLuint getShaderProgram() const { return shaderProgram; }
+    GLuint getFaceShaderProgram() const { return faceShaderProgram; }
+
+    // All binds for this context go through here (see GLStateCache)
+    GLStateCache& getState() { return state; }
 
 private:
     GLuint VAO, VBO, EBO;
     GLuint shaderProgram;
-    GLint viewLoc, projLoc, modelLoc;
+    GLuint faceShaderProgram;
+    GLuint cameraUBO;
+    GLint modelLoc;
+    GLint chunkOriginLoc;
+    GLsizeiptr cubeBufferBytes; // for the MemoryTracker
+    bool modelIsIdentity;       // chunks need it, drawCube changes it
+    GLStateCache state;
 
+    void setModelIdentity();
     void setupCubeVertices();
     GLuint compileShader(const std::string& source, GLenum shaderType);
-    GLuint createShaderProgram();
+    GLuint createShaderProgram(const std::string& vertexSource);
+    void createFaceShaderProgram();
 };
@@ -0,0 +1,70 @@
+#pragma once
+
+// Camera path recording and replay, for repeatable performance runs
+//
+// A CameraPath is the camera pose plus any block edits for every frame of a
+// session, and the world seed/render distance it was recorded with. Replays
+// step through it one frame per fixed timestep, so the same file always
+// loads the same chunks in the same order.
+//
+// File format is plain text, one record per line:
+//   seed <int>
+//   distance <int>
+//   frame <x> <y> <z> <yaw> <pitch>
+//   edit <x> <y> <z> <block type>     (belongs to the frame above it)
+// Floats are written with enough digits to read back exactly.
+
+#include "core/Stats.hpp"
+#include "world/World.hpp"
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct RecordedEdit {
+    int x, y, z;
+    BlockType type;
+};
+
+struct RecordedFrame {
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+    std::vector<RecordedEdit> edits; // applied before the world update
+};
+
+struct CameraPath {
+    int seed = 42;
+    int renderDistance = 4;
+    std::vector<RecordedFrame> frames;
+
+    // Both print to stderr and return false on failure
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+// Replays run at this rate no matter how fast frames actually render
+constexpr float REPLAY_DT = 1.0f / 60.0f;
+
+// Per-frame numbers for a replay: frame time, and how much streaming work
+// (chunk loads, meshing) the world did during each frame
+class ReplayReport {
+public:
+    void beginFrame(const World& world);
+    void endFrame(const World& world);
+
+    void print(std::ostream& out) const;
+
+private:
+    bool m_started = false;
+    WorldStats m_first;  // world stats when the replay started
+    WorldStats m_before; // ... and when the current frame started
+    WorldStats m_last;
+    std::chrono::steady_clock::time_point m_frameStart;
+
+    SampleStats m_frameMs;
+    SampleStats m_meshMs;
+    SampleStats m_chunksLoaded;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+// SampleStats - collects timing samples and reports percentiles
+// Keeps every sample, which is fine for the few hundred thousand a benchmark run makes
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+class SampleStats {
+public:
+    void add(double value) {
+        m_samples.push_back(value);
+        m_sorted = false;
+    }
+    void clear() {
+        m_samples.clear();
+        m_sorted = true;
+    }
+
+    std::size_t count() const { return m_samples.size(); }
+    bool empty() const { return m_samples.empty(); }
+
+    double mean() const {
+        if (m_samples.empty()) return 0.0;
+        double sum = 0.0;
+        for (double v : m_samples) sum += v;
+        return sum / m_samples.size();
+    }
+
+    // p in 0..100, nearest-rank
+    double percentile(double p) const {
+        if (m_samples.empty()) return 0.0;
+        sort();
+        std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100.0 * m_samples.size()));
+        return m_samples[std::min(std::max<std::size_t>(rank, 1), m_samples.size()) - 1];
+    }
+    double min() const { return percentile(0.0); }
+    double max() const { return percentile(100.0); }
+
+    // How many samples are above limit
+    std::size_t countAbove(double limit) const {
+        std::size_t n = 0;
+        for (double v : m_samples) n += v > limit;
+        return n;
+    }
+
+private:
+    void sort() const {
+        if (m_sorted) return;
+        std::sort(m_samples.begin(), m_samples.end());
+        m_sorted = true;
+    }
+
+    mutable std::vector<double> m_samples;
+    mutable bool m_sorted = true;
+};
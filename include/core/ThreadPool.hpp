@@ -0,0 +1,50 @@
+#pragma once
+
+// ThreadPool - a fixed set of worker threads for data-parallel loops
+// parallelFor() splits an index range over the workers and the calling
+// thread, and returns once every index has been processed.
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // threadCount = 0 picks one worker per hardware thread (minus the caller)
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Call fn(i) for every i in [0, count), spread across the pool
+    // fn must be safe to call concurrently for different i
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+    // Workers plus the calling thread
+    unsigned getConcurrency() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+private:
+    void workerLoop();
+    // Grab indices until the current job runs dry
+    void runJob();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_stopping = false;
+    uint64_t m_generation = 0;         // bumped for every parallelFor call
+    unsigned m_busy = 0;               // workers still inside the current job
+
+    // Current job
+    const std::function<void(std::size_t)>* m_fn = nullptr;
+    std::size_t m_count = 0;
+    std::atomic<std::size_t> m_next{0};
+};
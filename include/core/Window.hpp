@@ -3,11 +3,19 @@
 #include <GLFW/glfw3.h>
 #include <string>
 
+enum class WindowMode {
+    VISIBLE,
+    HIDDEN, // never shown, just for its GL context (render into an FBO)
+};
+
 class Window {
 public:
-    Window(int width, int height, const std::string& title);
+    Window(int width, int height, const std::string& title, WindowMode mode = WindowMode::VISIBLE);
     ~Window();
 
+    // False if the window or its GL context couldn't be created
+    bool hasContext() const { return m_window != nullptr; }
+
     bool isOpen() const;
     void update();
     void swapBuffers();
@@ -18,6 +26,7 @@ public:
     bool isKeyDown(int key) const;
     
     // Mouse stuff
+    bool isMouseButtonDown(int button) const;
     void enableRawMouse(bool enabled);
     // Returns how much the mouse moved (dx, dy) since last call
     std::pair<double, double> getMouseDelta();
@@ -31,6 +40,7 @@ private:
     int m_width;
     int m_height;
     std::string m_title;
+    WindowMode m_mode;
     // Track mouse position between frames
     double m_lastMouseX;
     double m_lastMouseY;
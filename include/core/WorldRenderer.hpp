@@ -0,0 +1,119 @@
+#pragma once
+
+// WorldRenderer - the GPU side of the world
+// Takes the meshes chunks build on the CPU, uploads them and draws them.
+// Meshes of chunks the world unloaded are recycled for the next chunks that
+// load, so streaming doesn't create GL objects once it's warmed up.
+// Draws whichever MeshFormat each chunk's mesh is in:
+//   VERTICES - one VAO/VBO/EBO per chunk, the Renderer's main shader
+//   FACES    - one buffer texture of packed faces per chunk, the Renderer's
+//              face shader, and no vertex attributes at all. Every chunk shares
+//              one VAO whose only state is a 4-vertices-per-quad index buffer
+// Every bind goes through the Renderer's GLStateCache. Draws come off a list
+// sorted by program, then front to back, so the program is set once per
+// format and the depth test rejects hidden chunks early.
+
+#include "core/RenderStats.hpp"
+#include "core/Renderer.hpp"
+#include "world/World.hpp"
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class WorldRenderer {
+public:
+    WorldRenderer() = default;
+    ~WorldRenderer();
+
+    WorldRenderer(const WorldRenderer&) = delete;
+    WorldRenderer& operator=(const WorldRenderer&) = delete;
+
+    // Upload any freshly built chunk meshes, then draw every loaded chunk
+    void render(World& world, Renderer& renderer, const glm::vec3& cameraPos);
+
+    // The two passes of render(), separately (e.g. to time them apart)
+    // Upload new meshes and free the ones of unloaded chunks
+    void uploadMeshes(World& world, Renderer& renderer, const glm::vec3& cameraPos);
+    // Draw everything uploaded so far, nearest chunks first
+    void draw(Renderer& renderer, const glm::vec3& cameraPos);
+
+    // Most meshes uploadMeshes() uploads per call, chunks that have nothing
+    // on screen yet first, then nearest first. 0 = no limit (the default)
+    void setUploadLimit(std::size_t meshes) { m_uploadLimit = meshes; }
+    std::size_t getUploadLimit() const { return m_uploadLimit; }
+    // Meshes the last uploadMeshes() left waiting because of the limit
+    std::size_t getPendingUploads() const { return m_pendingUploads; }
+
+    // GL work done since the last resetStats()
+    const RenderStats& getStats() const { return m_stats; }
+    void resetStats() { m_stats.reset(); }
+
+private:
+    struct ChunkMesh {
+        MeshFormat format = MeshFormat::VERTICES;
+        GLuint VAO = 0;
+        GLuint VBO = 0;     // vertices, or the packed faces for FACES
+        GLuint EBO = 0;
+        GLuint texture = 0; // FACES: buffer texture over VBO
+        GLsizei count = 0;  // indices, or faces for FACES
+        int64_t gpuBytes = 0; // buffer storage, for the MemoryTracker
+        int chunkX = 0;
+        int chunkZ = 0;
+        uint64_t lastSeen = 0; // frame this chunk was last in the world
+    };
+
+    // One entry of the draw list, sorted by key: format in the high bits,
+    // squared distance in chunks below
+    struct DrawItem {
+        uint64_t key;
+        const ChunkMesh* mesh;
+    };
+
+    using MeshMap = std::unordered_map<int64_t, ChunkMesh>;
+
+    // Meshes of unloaded chunks are kept, GL objects and map node alike, for
+    // the next chunks that load. At most a quarter of the live count (plus
+    // MIN_FREE_MESHES), anything over that is freed
+    static constexpr std::size_t MIN_FREE_MESHES = 64;
+    MeshMap::iterator retire(MeshMap::iterator it);
+    // New empty mesh for a chunk, recycled if there is one
+    void addMesh(int chunkX, int chunkZ);
+    void trimFreeMeshes();
+
+    void upload(GLStateCache& state, ChunkMesh& mesh, const ChunkMeshData& data);
+    void uploadFaces(GLStateCache& state, ChunkMesh& mesh, const ChunkMeshData& data);
+    void drawVertices(GLStateCache& state, const ChunkMesh& mesh);
+    void drawFaces(GLStateCache& state, GLint originLoc, const ChunkMesh& mesh);
+    // Grow the shared quad index buffer to cover faceCount faces
+    void reserveQuadIndices(GLStateCache& state, GLsizei faceCount);
+    // Frees the mesh's GL objects, call forgetReleased() before binding anything after
+    void release(ChunkMesh& mesh);
+    void forgetReleased(GLStateCache& state);
+    // Report a mesh's new buffer size to the MemoryTracker
+    static void trackBufferBytes(ChunkMesh& mesh, int64_t bytes);
+
+    static int64_t chunkKey(int chunkX, int chunkZ) {
+        return ((int64_t)chunkX << 32) | (uint32_t)chunkZ;
+    }
+
+    MeshMap m_meshes;
+    std::vector<MeshMap::node_type> m_freeMeshes;
+    std::vector<Chunk*> m_newChunks; // chunks without a mesh yet, this frame
+    std::vector<Chunk*> m_uploadQueue; // chunks whose pending mesh goes up this frame
+    std::size_t m_uploadLimit = 0;
+    std::size_t m_pendingUploads = 0;
+    ChunkMeshData m_scratch; // reused for every upload
+    std::size_t m_scratchBytes = 0;
+    uint64_t m_frame = 0;
+    RenderStats m_stats;
+    std::vector<DrawItem> m_drawList; // rebuilt every draw, kept for its capacity
+    bool m_released = false;          // GL objects deleted since the last forgetReleased()
+
+    GLuint m_faceVAO = 0;
+    GLuint m_quadEBO = 0;           // 0,1,2, 2,3,0, 4,5,6, ... for FACES draws
+    GLsizei m_quadCapacity = 0;     // faces m_quadEBO covers
+    int64_t m_quadBytes = 0;
+    GLint m_maxBufferTexels = 0;    // GL_MAX_TEXTURE_BUFFER_SIZE, read on first use
+};
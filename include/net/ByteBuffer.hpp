@@ -0,0 +1,105 @@
+#pragma once
+
+// ByteWriter / ByteReader - little-endian serialization for the wire protocol
+// Readers never throw: reading past the end sets a failure flag and returns 0,
+// so a truncated or garbage message is caught with one ok() check at the end.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void u8(uint8_t v) { m_out.push_back(v); }
+    void u16(uint16_t v) { put(v, 2); }
+    void u32(uint32_t v) { put(v, 4); }
+    void u64(uint64_t v) { put(v, 8); }
+    void i32(int32_t v) { u32(static_cast<uint32_t>(v)); }
+    void f32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, 4);
+        u32(bits);
+    }
+
+    // 7 bits per byte, high bit set on all but the last
+    void varint(uint32_t v) {
+        while (v >= 0x80) {
+            m_out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        m_out.push_back(static_cast<uint8_t>(v));
+    }
+
+    void bytes(const uint8_t* data, std::size_t size) { m_out.insert(m_out.end(), data, data + size); }
+
+    std::size_t size() const { return m_out.size(); }
+
+private:
+    void put(uint64_t v, int count) {
+        for (int i = 0; i < count; ++i) m_out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    std::vector<uint8_t>& m_out;
+};
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    uint8_t u8() { return static_cast<uint8_t>(get(1)); }
+    uint16_t u16() { return static_cast<uint16_t>(get(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(get(4)); }
+    uint64_t u64() { return get(8); }
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+    float f32() {
+        uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, 4);
+        return v;
+    }
+
+    uint32_t varint() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t b = u8();
+            v |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        m_failed = true;
+        return 0;
+    }
+
+    // Pointer to the next size bytes (and skip them), nullptr if there aren't that many
+    const uint8_t* bytes(std::size_t size) {
+        if (size > remaining()) {
+            m_failed = true;
+            return nullptr;
+        }
+        const uint8_t* p = m_data + m_pos;
+        m_pos += size;
+        return p;
+    }
+
+    std::size_t remaining() const { return m_failed ? 0 : m_size - m_pos; }
+    bool ok() const { return !m_failed; }
+
+private:
+    uint64_t get(int count) {
+        if (static_cast<std::size_t>(count) > remaining()) {
+            m_failed = true;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < count; ++i) v |= static_cast<uint64_t>(m_data[m_pos + i]) << (8 * i);
+        m_pos += count;
+        return v;
+    }
+
+    const uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_pos = 0;
+    bool m_failed = false;
+};
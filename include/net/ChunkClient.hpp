@@ -0,0 +1,69 @@
+#pragma once
+
+// ChunkClient - the receiving end of ChunkServer
+// Owns a REMOTE World that only ever holds what the server sent. Received
+// chunks are lit and meshed locally; block edits go to the server and come
+// back as deltas, so every client sees the same order of changes.
+
+#include "net/ChunkCodec.hpp"
+#include "net/Socket.hpp"
+#include "world/World.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ClientStats {
+    uint64_t chunksReceived = 0;
+    uint64_t chunkBytes = 0;    // CHUNK_DATA payload bytes
+    uint64_t deltasReceived = 0;
+    uint64_t unloadsReceived = 0;
+    double decodeMs = 0.0;      // decoding only, not lighting/meshing
+};
+
+class ChunkClient {
+public:
+    ChunkClient();
+
+    // Connect and say hello, false if the server can't be reached
+    bool connect(const std::string& host, uint16_t port, int viewDistance);
+    bool isConnected() const { return m_connection && m_connection->isOpen(); }
+
+    // Got WELCOME yet? Spawn point and view distance are only valid after
+    bool isReady() const { return m_ready; }
+    glm::vec3 getSpawn() const { return m_spawn; }
+    int getViewDistance() const { return m_viewDistance; }
+
+    // Where the camera is, sent whenever it moves a bit
+    void setPosition(const glm::vec3& position);
+
+    // Ask the server to change a block
+    void requestBlockEdit(int x, int y, int z, BlockType type);
+
+    // Send queued messages, apply everything that arrived
+    // New chunks are added to the world in one batch
+    void poll();
+
+    World& getWorld() { return m_world; }
+    const ClientStats& getStats() const { return m_stats; }
+
+private:
+    void handleMessage(Protocol::MessageType type, const std::vector<uint8_t>& payload);
+
+    World m_world;
+    std::unique_ptr<Connection> m_connection;
+
+    bool m_ready = false;
+    glm::vec3 m_spawn = glm::vec3(0.0f);
+    int m_viewDistance = 0;
+
+    glm::vec3 m_sentPosition = glm::vec3(0.0f);
+    bool m_positionSent = false;
+
+    std::vector<std::shared_ptr<Chunk>> m_received; // this poll's chunks
+    std::vector<BlockChange> m_changes;
+    std::vector<uint8_t> m_scratch;
+
+    ClientStats m_stats;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+// ChunkCodec - chunk blocks <-> compact bytes for the network
+//
+// CHUNK_DATA payload:
+//   i32 chunk x, i32 chunk z, varint raw size, LZ-compressed body (raw size bytes)
+// body:
+//   u16 section mask (bit s = section s has something other than air)
+//   for every section in the mask:
+//     u8 palette size - 1, palette entries (u8 block type each)
+//     u8 bits per block (0 when the palette has one entry)
+//     packed palette indices, 64 / bits of them per u64 word (no entry spans two
+//     words), in the section's y * 256 + z * 16 + x order
+//
+// BLOCK_DELTA payload:
+//   i32 chunk x, i32 chunk z, varint count, count x (u16 block index, u8 block type)
+//
+// Light isn't sent: it only depends on the blocks, so the client's LightEngine
+// works it out the same way the server's did.
+
+#include "world/Chunk.hpp"
+#include "world/ChunkPool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct BlockChange {
+    uint16_t index; // y * 256 + z * 16 + x inside the chunk
+    BlockType type;
+};
+
+// Running totals, for benchmarks
+struct CodecStats {
+    std::size_t chunks = 0;
+    std::size_t rawBytes = 0;       // blocks as one byte each
+    std::size_t packedBytes = 0;    // after palette + bit-packing
+    std::size_t compressedBytes = 0; // whole payload as sent
+};
+
+namespace ChunkCodec {
+    // Append a CHUNK_DATA payload for chunk to out
+    void encodeChunk(const Chunk& chunk, std::vector<uint8_t>& out, CodecStats* stats = nullptr);
+
+    // Build a chunk from a CHUNK_DATA payload, nullptr if it's malformed
+    // The chunk comes from pool if there is one
+    std::shared_ptr<Chunk> decodeChunk(const uint8_t* data, std::size_t size, ChunkPool* pool = nullptr);
+
+    // Append a BLOCK_DELTA payload to out
+    void encodeDelta(int chunkX, int chunkZ, const std::vector<BlockChange>& changes, std::vector<uint8_t>& out);
+
+    // Parse a BLOCK_DELTA payload, false if it's malformed
+    bool decodeDelta(const uint8_t* data, std::size_t size, int& chunkX, int& chunkZ, std::vector<BlockChange>& changes);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// ChunkServer - streams a Simulation's world to network clients
+//
+// Each client is a viewer in the simulation, placed wherever its camera is.
+// Interest management: every client has its own view distance and the set of
+// chunks it has been sent. Each tick the nearest loaded chunks it hasn't got
+// go out first (a few per tick, and only while its send queue is short), and
+// chunks that fell more than one past its view distance get an UNLOAD.
+// Block edits are applied to the world and sent as per-chunk deltas to every
+// client holding that chunk, and so are the blocks the world's own block
+// ticks change (flowing water, grass).
+
+#include "net/ChunkCodec.hpp"
+#include "net/Socket.hpp"
+#include "world/Simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class ChunkServer {
+public:
+    // Per-client streaming limits
+    static constexpr int MAX_CHUNKS_PER_TICK = 8;
+    static constexpr std::size_t MAX_PENDING_BYTES = 512 * 1024;
+
+    // Streams sim's world; view distances are capped to the simulation's
+    explicit ChunkServer(Simulation& sim);
+
+    // false if the port can't be opened (port 0 picks a free one)
+    bool listen(uint16_t port);
+    uint16_t getPort() const { return m_listener ? m_listener->getPort() : 0; }
+
+    // Accept and read clients, advance the simulation, send updates
+    void tick();
+
+    // Send what earlier ticks left queued, without ticking. False while
+    // some client still has bytes waiting
+    bool flush();
+
+    // Edit a block server-side, clients get it like any other edit
+    void setBlock(int x, int y, int z, BlockType type);
+
+    std::size_t getClientCount() const { return m_clients.size(); }
+    const CodecStats& getCodecStats() const { return m_codecStats; }
+    uint64_t getChunksSent() const { return m_chunksSent; }
+
+private:
+    struct Client {
+        std::unique_ptr<Connection> connection;
+        std::size_t viewer = 0;
+        bool ready = false;        // sent HELLO, got WELCOME
+        int viewDistance = 0;
+        int chunkX = 0, chunkZ = 0; // chunk the camera is in
+        bool complete = false;     // has every chunk in view, nothing to scan for
+        std::unordered_set<int64_t> sent;
+    };
+
+    struct CachedChunk {
+        const Chunk* chunk = nullptr; // what it was encoded from
+        std::vector<uint8_t> payload;
+    };
+
+    void acceptClients();
+    void readClient(Client& client);
+    void handleMessage(Client& client, Protocol::MessageType type, const std::vector<uint8_t>& payload);
+    void streamChunks(Client& client);
+    void sendEdits();
+
+    // Queue a block that changed in the world for the clients
+    void recordEdit(int x, int y, int z, BlockType type);
+
+    // CHUNK_DATA payload for a loaded chunk, encoded once and shared by all clients
+    const std::vector<uint8_t>& encoded(const Chunk& chunk);
+
+    static int64_t chunkKey(int chunkX, int chunkZ) {
+        return ((int64_t)chunkX << 32) | (uint32_t)chunkZ;
+    }
+
+    Simulation& m_sim;
+    std::unique_ptr<Listener> m_listener;
+    std::vector<Client> m_clients;
+
+    // Edits this tick, grouped by chunk
+    std::map<int64_t, std::vector<BlockChange>> m_edits;
+
+    std::unordered_map<int64_t, CachedChunk> m_cache;
+    uint64_t m_cacheEpoch = 0;
+
+    CodecStats m_codecStats;
+    uint64_t m_chunksSent = 0;
+    std::vector<uint8_t> m_scratch;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+// LZ4-style block compression for network payloads
+// Same sequence format as an LZ4 block (token, literals, 16-bit offset, match
+// length), greedy matching with a single hash table. Chunk data is mostly long
+// runs and repeated packed words, which this eats up.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Lz {
+    // Worst case compressed size for n input bytes
+    constexpr std::size_t compressBound(std::size_t n) { return n + n / 255 + 16; }
+
+    // Append the compressed form of src to out
+    void compress(const uint8_t* src, std::size_t size, std::vector<uint8_t>& out);
+
+    // Decompress into exactly dstSize bytes
+    // Returns false on malformed input (never reads or writes out of bounds)
+    bool decompress(const uint8_t* src, std::size_t size, uint8_t* dst, std::size_t dstSize);
+}
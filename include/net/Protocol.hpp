@@ -0,0 +1,32 @@
+#pragma once
+
+// Wire protocol between the world server and its clients
+//
+// Every message on the TCP stream is framed as
+//   u32 length (of everything after it)  u8 type  payload
+// all little-endian. Payload layouts are listed next to each type; chunk
+// payloads are described in ChunkCodec.hpp.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Protocol {
+    constexpr uint32_t VERSION = 1;
+    constexpr uint16_t DEFAULT_PORT = 25575;
+
+    // Anything bigger is a broken or hostile peer
+    constexpr std::size_t MAX_MESSAGE_SIZE = 1 << 20;
+
+    enum class MessageType : uint8_t {
+        // client -> server
+        HELLO = 1,        // u32 version, u8 view distance
+        POSITION,         // f32 x, y, z (camera position)
+        BLOCK_EDIT,       // i32 x, i32 y, i32 z, u8 block type
+
+        // server -> client
+        WELCOME = 64,     // i32 seed, u8 view distance granted, f32 spawn x, y, z
+        CHUNK_DATA,       // full chunk, see ChunkCodec::encodeChunk
+        CHUNK_UNLOAD,     // i32 chunk x, i32 chunk z
+        BLOCK_DELTA,      // block changes inside one chunk, see ChunkCodec::encodeDelta
+    };
+}
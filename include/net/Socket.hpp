@@ -0,0 +1,80 @@
+#pragma once
+
+// Non-blocking TCP with message framing (POSIX sockets)
+// Connection buffers whole outgoing messages and hands back whole incoming
+// ones; nothing here ever blocks except connect(). Call flush() and receive()
+// once per tick/frame.
+
+#include "net/Protocol.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Connection {
+public:
+    // Takes ownership of a connected socket
+    explicit Connection(int fd);
+    ~Connection();
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    // Blocking connect, nullptr (and a message on stderr) on failure
+    static std::unique_ptr<Connection> connect(const std::string& host, uint16_t port);
+
+    // Queue a message, sent by the next flush()
+    void send(Protocol::MessageType type, const std::vector<uint8_t>& payload);
+
+    // Write as much of the queue as the socket takes
+    // Both return false once the connection is dead
+    bool flush();
+    // Read whatever has arrived
+    bool receive();
+
+    // Pop the next complete incoming message, false if there isn't one
+    bool nextMessage(Protocol::MessageType& type, std::vector<uint8_t>& payload);
+
+    // Hang up, anything still queued is dropped
+    void disconnect();
+
+    bool isOpen() const { return m_fd >= 0; }
+    // Bytes queued but not written yet, for backpressure
+    std::size_t getPendingBytes() const { return m_outbox.size() - m_outboxHead; }
+    uint64_t getBytesSent() const { return m_bytesSent; }
+    uint64_t getBytesReceived() const { return m_bytesReceived; }
+
+private:
+    int m_fd;
+
+    std::vector<uint8_t> m_outbox;
+    std::size_t m_outboxHead = 0; // first byte not written yet
+    std::vector<uint8_t> m_inbox;
+    std::size_t m_inboxHead = 0;  // first byte not handed out yet
+
+    uint64_t m_bytesSent = 0;
+    uint64_t m_bytesReceived = 0;
+};
+
+class Listener {
+public:
+    ~Listener();
+
+    Listener(const Listener&) = delete;
+    Listener& operator=(const Listener&) = delete;
+
+    // Listen on all interfaces (port 0 picks a free one), nullptr on failure
+    static std::unique_ptr<Listener> listen(uint16_t port);
+
+    // Next pending connection, nullptr if nobody is waiting
+    std::unique_ptr<Connection> accept();
+
+    uint16_t getPort() const { return m_port; }
+
+private:
+    Listener(int fd, uint16_t port) : m_fd(fd), m_port(port) {}
+
+    int m_fd;
+    uint16_t m_port;
+};
@@ -1,6 +1,15 @@
 #pragma once
 
+// Block types and the block registry
+// Every block's properties live in one table (BLOCK_DEFS below). The hot
+// properties are turned into flat compile-time tables - bitmasks for the
+// yes/no flags, arrays for everything else - so lookups in the mesher,
+// lighting and physics are a shift-and-mask or a single array read.
+//
+// Adding a block type = add it to BlockType and add its row to BLOCK_DEFS.
+
 #include <cstdint>
+#include <cstddef>
 #include <array>
 
 enum class BlockType : uint8_t {
@@ -12,35 +21,146 @@ enum class BlockType : uint8_t {
     WATER,
     WOOD,
     LEAVES,
+    GLOWSTONE,
+    // Water flowing out of a WATER source, weakest first (see waterLevel())
+    // Only the block tick simulation places these
+    FLOWING_WATER_1,
+    FLOWING_WATER_2,
+    FLOWING_WATER_3,
+    FLOWING_WATER_4,
+    FLOWING_WATER_5,
+    FLOWING_WATER_6,
+    FLOWING_WATER_7,
     COUNT
 };
 
-struct BlockData {
-    bool isSolid;
-    bool isTransparent;
-    float color[3];
+// Face order used everywhere (mesher, raycasts, lighting): -X, +X, -Z, +Z, -Y, +Y
+constexpr int FACE_COUNT = 6;
+constexpr int FACE_BOTTOM = 4;
+constexpr int FACE_TOP = 5;
+
+struct BlockColor {
+    float r, g, b;
+};
+
+struct BlockDef {
+    const char* name;
+    bool isSolid;          // collides, and hides faces of the blocks next to it
+    bool isTransparent;    // can be seen through
+    bool randomTicks;      // reacts to random ticks (see BlockTicks)
+    uint8_t lightOpacity;  // light lost passing through (15 = blocks light completely)
+    uint8_t lightEmission; // block light level this block gives off (0-15)
+    BlockColor top;
+    BlockColor bottom;
+    BlockColor side;
 };
 
-namespace BlockDB {
-    inline const BlockData& get(BlockType type) {
-        static const std::array<BlockData, static_cast<std::size_t>(BlockType::COUNT)> data = {{
-            { false, true,  {0.0f,  0.0f,  0.0f } },  // AIR
-            { true,  false, {0.5f,  0.5f,  0.5f } },  // STONE
-            { true,  false, {0.55f, 0.36f, 0.23f} },  // DIRT
-            { true,  false, {0.2f,  0.8f,  0.2f } },  // GRASS (top color)
-            { true,  false, {0.9f,  0.85f, 0.6f } },  // SAND
-            { false, true,  {0.2f,  0.4f,  0.8f } },  // WATER
-            { true,  false, {0.55f, 0.35f, 0.15f} },  // WOOD
-            { true,  false, {0.1f,  0.6f,  0.1f } },  // LEAVES
-        }};
-        return data[static_cast<std::size_t>(type)];
+namespace BlockRegistry {
+    constexpr std::size_t COUNT = static_cast<std::size_t>(BlockType::COUNT);
+
+    // Indexed by BlockType
+    constexpr BlockDef BLOCK_DEFS[] = {
+        //  name               solid  transp ticks  opac emit  top                    bottom                 side
+        { "air",             false, true,  false, 0,  0,  {0.0f,  0.0f,  0.0f }, {0.0f,  0.0f,  0.0f }, {0.0f,  0.0f,  0.0f } },
+        { "stone",           true,  false, false, 15, 0,  {0.5f,  0.5f,  0.5f }, {0.5f,  0.5f,  0.5f }, {0.5f,  0.5f,  0.5f } },
+        { "dirt",            true,  false, false, 15, 0,  {0.55f, 0.36f, 0.23f}, {0.55f, 0.36f, 0.23f}, {0.55f, 0.36f, 0.23f} },
+        { "grass",           true,  false, true,  15, 0,  {0.2f,  0.8f,  0.2f }, {0.55f, 0.36f, 0.23f}, {0.45f, 0.6f,  0.2f } },
+        { "sand",            true,  false, false, 15, 0,  {0.9f,  0.85f, 0.6f }, {0.9f,  0.85f, 0.6f }, {0.9f,  0.85f, 0.6f } },
+        { "water",           false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+        { "wood",            true,  false, false, 15, 0,  {0.55f, 0.35f, 0.15f}, {0.55f, 0.35f, 0.15f}, {0.55f, 0.35f, 0.15f} },
+        { "leaves",          true,  false, false, 15, 0,  {0.1f,  0.6f,  0.1f }, {0.1f,  0.6f,  0.1f }, {0.1f,  0.6f,  0.1f } },
+        { "glowstone",       true,  false, false, 15, 15, {1.0f,  0.85f, 0.5f }, {1.0f,  0.85f, 0.5f }, {1.0f,  0.85f, 0.5f } },
+        { "flowing water 1", false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+        { "flowing water 2", false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+        { "flowing water 3", false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+        { "flowing water 4", false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+        { "flowing water 5", false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+        { "flowing water 6", false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+        { "flowing water 7", false, true,  false, 2,  0,  {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f }, {0.2f,  0.4f,  0.8f } },
+    };
+    static_assert(sizeof(BLOCK_DEFS) / sizeof(BLOCK_DEFS[0]) == COUNT,
+                  "every BlockType needs a row in BLOCK_DEFS");
+    static_assert(COUNT <= 64, "flag masks are 64 bits wide");
+
+    // One bit per block type
+    template <bool BlockDef::*Flag>
+    constexpr uint64_t buildMask() {
+        uint64_t mask = 0;
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            if (BLOCK_DEFS[i].*Flag) mask |= uint64_t(1) << i;
+        }
+        return mask;
+    }
+
+    template <uint8_t BlockDef::*Field>
+    constexpr std::array<uint8_t, COUNT> buildTable() {
+        std::array<uint8_t, COUNT> table{};
+        for (std::size_t i = 0; i < COUNT; ++i) table[i] = BLOCK_DEFS[i].*Field;
+        return table;
+    }
+
+    // Color for each (type, face), faces in the usual order
+    constexpr std::array<std::array<BlockColor, FACE_COUNT>, COUNT> buildFaceColors() {
+        std::array<std::array<BlockColor, FACE_COUNT>, COUNT> table{};
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            for (int f = 0; f < FACE_COUNT; ++f) {
+                table[i][f] = f == FACE_TOP ? BLOCK_DEFS[i].top
+                            : f == FACE_BOTTOM ? BLOCK_DEFS[i].bottom
+                            : BLOCK_DEFS[i].side;
+            }
+        }
+        return table;
     }
+
+    constexpr uint64_t SOLID_MASK = buildMask<&BlockDef::isSolid>();
+    constexpr uint64_t TRANSPARENT_MASK = buildMask<&BlockDef::isTransparent>();
+    constexpr uint64_t RANDOM_TICK_MASK = buildMask<&BlockDef::randomTicks>();
+    constexpr std::array<uint8_t, COUNT> LIGHT_OPACITY = buildTable<&BlockDef::lightOpacity>();
+    constexpr std::array<uint8_t, COUNT> LIGHT_EMISSION = buildTable<&BlockDef::lightEmission>();
+    constexpr std::array<std::array<BlockColor, FACE_COUNT>, COUNT> FACE_COLORS = buildFaceColors();
+
+    constexpr const BlockDef& get(BlockType type) {
+        return BLOCK_DEFS[static_cast<std::size_t>(type)];
+    }
+
+    constexpr const BlockColor& faceColor(BlockType type, int face) {
+        return FACE_COLORS[static_cast<std::size_t>(type)][face];
+    }
+}
+
+constexpr bool isSolid(BlockType type) {
+    return (BlockRegistry::SOLID_MASK >> static_cast<unsigned>(type)) & 1u;
+}
+
+constexpr bool isTransparent(BlockType type) {
+    return (BlockRegistry::TRANSPARENT_MASK >> static_cast<unsigned>(type)) & 1u;
+}
+
+constexpr bool hasRandomTicks(BlockType type) {
+    return (BlockRegistry::RANDOM_TICK_MASK >> static_cast<unsigned>(type)) & 1u;
 }
 
-inline bool isSolid(BlockType type) {
-    return BlockDB::get(type).isSolid;
+constexpr uint8_t lightOpacity(BlockType type) {
+    return BlockRegistry::LIGHT_OPACITY[static_cast<std::size_t>(type)];
+}
+
+constexpr uint8_t lightEmission(BlockType type) {
+    return BlockRegistry::LIGHT_EMISSION[static_cast<std::size_t>(type)];
+}
+
+// Water levels: a WATER source is 8, flowing water 7 (next to a source, or
+// falling) down to 1 at the far edge of the flow, anything else 0
+constexpr int WATER_SOURCE_LEVEL = 8;
+
+constexpr int waterLevel(BlockType type) {
+    if (type == BlockType::WATER) return WATER_SOURCE_LEVEL;
+    if (type >= BlockType::FLOWING_WATER_1 && type <= BlockType::FLOWING_WATER_7) {
+        return static_cast<int>(type) - static_cast<int>(BlockType::FLOWING_WATER_1) + 1;
+    }
+    return 0;
 }
 
-inline bool isTransparent(BlockType type) {
-    return BlockDB::get(type).isTransparent;
+// Flowing water of level 1-7
+constexpr BlockType flowingWater(int level) {
+    return static_cast<BlockType>(static_cast<int>(BlockType::FLOWING_WATER_1) + level - 1);
 }
@@ -0,0 +1,126 @@
+#pragma once
+
+// BlockTicks - blocks that change by themselves over time, for the World
+//
+// Scheduled ticks: a block asks to be updated again N ticks from now. They
+// sit in a timing wheel (one bucket per tick, WHEEL_SLOTS of them), so
+// scheduling and finding what's due are both O(1) - nothing ever scans the
+// world for blocks that might need an update. Water is what uses them: any
+// change next to water wakes it, and a water block that finds nothing to do
+// doesn't schedule itself again, so a settled lake costs nothing and the
+// cost of a tick follows the number of cells actually flowing.
+//
+// Random ticks: every tick a few random blocks of each loaded section get
+// poked, whatever is there. Blocks with randomTicks set in the registry
+// react (grass spreads onto lit dirt and dies under solid blocks).
+//
+// Blocks change through World::setBlock(). World::tick() relights them at
+// the end of the tick, a few chunks per tick (see LIGHT_CHUNKS_PER_TICK),
+// and World::update() remeshes each chunk once its light is done.
+// REMOTE worlds don't simulate, their server sends the changes.
+
+#include "world/ChunkNeighborhood.hpp"
+#include "world/RegionEdit.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+class World;
+
+// A block changed by the last tick, in world block coords
+struct TickChange {
+    int x, y, z;
+    BlockType type;
+};
+
+class BlockTicks {
+public:
+    // Longest delay schedule() takes, in ticks
+    static constexpr int WHEEL_SLOTS = 64;
+    // Ticks between water flowing one block (at Player::TICK_RATE, ~6 blocks/s)
+    static constexpr int WATER_DELAY = 10;
+    // Scheduled updates run per tick at most, the rest wait for the next
+    // one. Keeps a whole lake draining at once from stalling the game
+    static constexpr std::size_t MAX_UPDATES_PER_TICK = 4096;
+    // Random blocks poked per 16x16x16 section per tick
+    static constexpr int RANDOM_TICKS_PER_SECTION = 1;
+
+    BlockTicks(World& world, uint32_t seed) : m_world(world), m_rng(seed) {}
+
+    // Update the block at world (x, y, z) delay ticks from now (1 to WHEEL_SLOTS - 1)
+    void schedule(int x, int y, int z, int delay);
+
+    // The block at world (x, y, z) changed: wake the water in and around it
+    void onBlockChanged(int x, int y, int z);
+
+    // Same for a bulk edit: wakes the water in and around the box that has
+    // somewhere to flow now, and all flowing water there (it may have lost
+    // what fed it). Reads the whole box, a lot cheaper than the relight
+    void onBoxChanged(const BlockBox& box);
+
+    // A chunk was loaded: wake the water in its loaded neighbors that was
+    // waiting at the edge for it
+    void onChunkLoaded(int chunkX, int chunkZ);
+
+    // Run the scheduled updates that are due, then the random ticks
+    void tick();
+
+    uint64_t getTickCount() const { return m_tick; }
+    // Scheduled updates waiting in the wheel, or left over from a full tick
+    std::size_t getPendingCount() const { return m_pending + m_overflow.size(); }
+
+    // What the last tick() did
+    std::size_t getLastUpdates() const { return m_lastUpdates; }    // scheduled updates run
+    std::size_t getLastRandomHits() const { return m_lastRandomHits; } // random ticks that hit a ticking block
+    // Blocks it changed, in the order it changed them (servers forward these)
+    const std::vector<TickChange>& getChanges() const { return m_changes; }
+
+private:
+    // Wheel entries: chunk coords then section-local position, so sorting
+    // a bucket groups its updates by chunk
+    static uint64_t pack(int x, int y, int z);
+    static void unpack(uint64_t key, int& x, int& y, int& z);
+
+    void runScheduled();
+    void runRandom();
+
+    // Center m_area on the chunk holding column (x, z), false if it isn't loaded
+    bool focus(int x, int z);
+    BlockType get(int x, int y, int z) const;
+    void set(int x, int y, int z, BlockType type);
+
+    // Water at (x, y, z): dry up, fill up or flow on, from what's around it
+    void tickWater(int x, int y, int z);
+    // Level flowing water here should have: 7 under water, else the best
+    // neighbor that spreads sideways minus one
+    int feedLevel(int x, int y, int z) const;
+    // The water here has somewhere to flow
+    bool canSpread(int x, int y, int z) const;
+    // Water here goes sideways only once it can't fall any further
+    bool spreadsSideways(int x, int y, int z) const;
+    // Water can flow into air and into weaker flowing water
+    static bool canFlowInto(BlockType type, int level) {
+        return type == BlockType::AIR || (type != BlockType::WATER && waterLevel(type) > 0 && waterLevel(type) < level);
+    }
+
+    void tickGrass(int x, int y, int z);
+
+    World& m_world;
+    ChunkNeighborhood m_area;
+
+    std::array<std::vector<uint64_t>, WHEEL_SLOTS> m_wheel;
+    std::vector<uint64_t> m_due;      // what runs this tick
+    std::vector<uint64_t> m_overflow; // due, but over MAX_UPDATES_PER_TICK, oldest first
+    std::vector<uint64_t> m_waiting;  // m_overflow sorted, to keep it free of repeats
+    std::size_t m_pending = 0;
+    uint64_t m_tick = 0;
+
+    std::mt19937 m_rng;
+    std::vector<glm::ivec3> m_randomHits;
+
+    std::size_t m_lastUpdates = 0;
+    std::size_t m_lastRandomHits = 0;
+    std::vector<TickChange> m_changes;
+};
@@ -1,13 +1,54 @@
 #pragma once
 
 // Chunk - 16x16x256 section of blocks
-// Stores block data and generates a mesh for rendering
-// Basically all visible faces get baked into one VAO/VBO
+// Stores block data and builds the CPU side of its mesh
+// No GL in here - WorldRenderer uploads the meshes, so the world also runs headless
 
 #include "world/Block.hpp"
 #include <glm/glm.hpp>
-#include <vector>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <vector>
+
+class ChunkNeighborhood;
+
+// How chunk meshes are laid out for the GPU
+enum class MeshFormat {
+    VERTICES, // 4 vertices + 6 indices per face, 120 bytes
+    FACES,    // one packed 8-byte record per face, the vertex shader builds the quad
+};
+
+// CPU side of a chunk mesh
+// VERTICES: vertex = position (x,y,z) + color (r,g,b), light and AO baked in
+// FACES: 2 words per face, block coords local to the chunk
+//   word 0: x (4 bits) | z (4) << 4 | y (8) << 8 | face (3) << 16
+//           | block type (8) << 19 | flipped diagonal (1) << 27
+//   word 1: AO of the 4 corners (2 bits each, 3 = open) | light level (4) << 8
+// Corner order and diagonal choice are the mesher's (see Chunk.cpp), and
+// the face shader in Renderer.cpp unpacks the same layout
+struct ChunkMeshData {
+    MeshFormat format = MeshFormat::VERTICES;
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<uint32_t> faces;
+
+    // Heap memory held, including spare capacity
+    std::size_t capacityBytes() const {
+        return vertices.capacity() * sizeof(float) + indices.capacity() * sizeof(unsigned int) +
+               faces.capacity() * sizeof(uint32_t);
+    }
+
+    std::size_t faceCount() const {
+        return format == MeshFormat::FACES ? faces.size() / 2 : indices.size() / 6;
+    }
+
+    void clear() {
+        vertices.clear();
+        indices.clear();
+        faces.clear();
+    }
+};
 
 class Chunk {
 public:
@@ -16,10 +57,27 @@ public:
     static constexpr int HEIGHT = 256; // y dimension (world height)
     static constexpr int VOLUME = WIDTH * DEPTH * HEIGHT;
 
+    // Chunks are split vertically into 16-high sections (16x16x16 blocks)
+    static constexpr int SECTION_HEIGHT = 16;
+    static constexpr int SECTION_COUNT = HEIGHT / SECTION_HEIGHT;
+    static constexpr int SECTION_VOLUME = WIDTH * DEPTH * SECTION_HEIGHT;
+
+    static constexpr uint8_t MAX_LIGHT = 15;
+
     // Create a chunk at world chunk coords (chunkX, chunkZ)
+    // All the block and light storage is inline (~128 KB), so this is a single
+    // allocation - or none, when it comes from a ChunkPool
     Chunk(int chunkX, int chunkZ);
     ~Chunk();
 
+    // Turn this into a fresh, empty chunk at (chunkX, chunkZ), for recycling
+    // Any pending mesh is dropped, its buffers keep their capacity
+    void reset(int chunkX, int chunkZ);
+
+    // Not copyable, the memory accounting (see MemoryTracker) follows the object
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
     // Get block at local position (0-15, 0-255, 0-15)
     // Returns AIR if out of bounds
     BlockType getBlock(int x, int y, int z) const;
@@ -27,12 +85,47 @@ public:
     // Set block at local position
     void setBlock(int x, int y, int z, BlockType type);
 
-    // Generate mesh from current blocks
-    // Iterates through blocks, builds vertices for visible faces, uploads to GPU
-    void generateMesh();
+    // Raw blocks of one 16x16x16 section, indexed y * 256 + z * 16 + x
+    // (y relative to the section). For bulk readers/writers like the network codec
+    const BlockType* getSectionBlocks(int section) const { return &m_blocks[section * SECTION_VOLUME]; }
+    BlockType* getSectionBlocks(int section) { return &m_blocks[section * SECTION_VOLUME]; }
+
+    // Light levels (0-15) at local position
+    // Above the chunk is open sky, below/sideways out of bounds is dark
+    uint8_t getSkyLight(int x, int y, int z) const {
+        if (y >= HEIGHT) return MAX_LIGHT;
+        if (!isInBounds(x, y, z)) return 0;
+        return m_light[getBlockIndex(x, y, z)] >> 4;
+    }
+    uint8_t getBlockLight(int x, int y, int z) const {
+        if (!isInBounds(x, y, z)) return 0;
+        return m_light[getBlockIndex(x, y, z)] & 0x0F;
+    }
+    // No bounds checks, for the light engine
+    void setSkyLight(int x, int y, int z, uint8_t level) {
+        uint8_t& l = m_light[getBlockIndex(x, y, z)];
+        l = static_cast<uint8_t>((level << 4) | (l & 0x0F));
+    }
+    void setBlockLight(int x, int y, int z, uint8_t level) {
+        uint8_t& l = m_light[getBlockIndex(x, y, z)];
+        l = static_cast<uint8_t>((l & 0xF0) | level);
+    }
+    // Everything dark again, before relighting from scratch
+    void clearLight() { m_light.fill(0); }
 
-    // Draw this chunk with the given shader
-    void render(unsigned int shaderProgram, const glm::mat4& modelMatrix) const;
+    // Build the mesh on the CPU from current blocks
+    // Iterates through blocks and emits every visible face, with its light and
+    // per-vertex ambient occlusion, in the given format. No GL calls.
+    // neighbors (optional) lets faces on the chunk border sample the next chunk
+    void buildMesh(const ChunkNeighborhood* neighbors, ChunkMeshData& out, bool ambientOcclusion = true,
+                   MeshFormat format = MeshFormat::VERTICES) const;
+
+    // Rebuild this chunk's mesh and keep it until the renderer takes it
+    void generateMesh(const ChunkNeighborhood* neighbors = nullptr, MeshFormat format = MeshFormat::VERTICES);
+    bool hasPendingMesh() const { return m_hasPendingMesh; }
+
+    // Hand the pending mesh over (swapped into out), false if there isn't one
+    bool takePendingMesh(ChunkMeshData& out);
 
     // Get world position (bottom-left corner of chunk)
     glm::vec3 getWorldPosition() const;
@@ -40,9 +133,10 @@ public:
     // Getters
     int getChunkX() const { return m_chunkX; }
     int getChunkZ() const { return m_chunkZ; }
-    
-    // Check if we have a valid mesh to render
-    bool hasMesh() const { return m_indexCount > 0; }
+
+    // Set when blocks change after the mesh was built, cleared by generateMesh()
+    bool isDirty() const { return m_dirty; }
+    void markDirty() { m_dirty = true; }
 
 private:
     // Check if block has at least one exposed face
@@ -57,13 +151,21 @@ private:
     int m_chunkZ;
 
     // 16 * 16 * 256 = 65,536 blocks per chunk
-    std::vector<BlockType> m_blocks;
+    std::array<BlockType, VOLUME> m_blocks;
+
+    // Light for each block, same layout as m_blocks so every section is a
+    // contiguous 4 KB run. Packed nibbles: sky light high, block light low
+    std::array<uint8_t, VOLUME> m_light;
+
+    // Built by generateMesh(), waiting for the renderer
+    ChunkMeshData m_pendingMesh;
+    bool m_hasPendingMesh = false;
+    std::size_t m_meshBytes = 0; // m_pendingMesh's capacity as last reported
+
+    // Report m_pendingMesh's size change to the MemoryTracker
+    void trackMeshMemory();
 
-    // GPU stuff
-    unsigned int m_VAO = 0;
-    unsigned int m_VBO = 0;
-    unsigned int m_EBO = 0;
-    unsigned int m_indexCount = 0; // how many indices in the mesh
+    bool m_dirty = false;
 
     // Get linear index for a block in the array
     inline int getBlockIndex(int x, int y, int z) const {
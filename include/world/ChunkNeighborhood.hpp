@@ -0,0 +1,62 @@
+#pragma once
+
+// ChunkNeighborhood - the 3x3 chunks around a center chunk
+// Chunk pointers are looked up once, so block reads near the center
+// (collision, lighting, meshing) never go through the World's chunk map
+
+#include "world/Chunk.hpp"
+#include <cstdint>
+
+class World;
+
+class ChunkNeighborhood {
+public:
+    static constexpr int SPAN_X = 3 * Chunk::WIDTH;
+    static constexpr int SPAN_Z = 3 * Chunk::DEPTH;
+
+    ChunkNeighborhood() = default;
+    ChunkNeighborhood(const World& world, int centerX, int centerZ) { reset(world, centerX, centerZ); }
+
+    // Look up the 3x3 chunks around (centerX, centerZ)
+    void reset(const World& world, int centerX, int centerZ);
+
+    // True if chunks were loaded/unloaded since reset(), so the cached pointers may be stale
+    bool isStale(const World& world) const;
+
+    int getCenterX() const { return m_centerX; }
+    int getCenterZ() const { return m_centerZ; }
+    // World block coords of the 3x3's min corner
+    int getOriginX() const { return m_originX; }
+    int getOriginZ() const { return m_originZ; }
+
+    // Same as chunkAt() but with x/z relative to the origin (0 .. SPAN-1)
+    Chunk* chunkAtLocal(int lx, int lz) const {
+        if (static_cast<unsigned>(lx) >= static_cast<unsigned>(SPAN_X) ||
+            static_cast<unsigned>(lz) >= static_cast<unsigned>(SPAN_Z)) {
+            return nullptr;
+        }
+        return m_chunks[lz / Chunk::DEPTH][lx / Chunk::WIDTH];
+    }
+
+    // Chunk holding world block column (x, z)
+    // nullptr if the chunk isn't loaded or the column is outside the 3x3
+    Chunk* chunkAt(int x, int z) const {
+        return chunkAtLocal(x - m_originX, z - m_originZ);
+    }
+
+    // Block at world block coords, AIR if not available
+    BlockType getBlock(int x, int y, int z) const {
+        const Chunk* chunk = chunkAt(x, z);
+        if (!chunk) return BlockType::AIR;
+        return chunk->getBlock(x - chunk->getChunkX() * Chunk::WIDTH, y,
+                               z - chunk->getChunkZ() * Chunk::DEPTH);
+    }
+
+private:
+    Chunk* m_chunks[3][3] = {}; // [z][x], center at [1][1]
+    int m_centerX = 0;
+    int m_centerZ = 0;
+    int m_originX = 0; // world block x of the 3x3's min corner
+    int m_originZ = 0;
+    uint64_t m_epoch = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+// ChunkPool - recycles Chunk objects as the world streams in and out
+// Chunks are built in slabs of SLAB_CHUNKS, one big allocation each, and
+// never freed individually: a chunk nobody but the pool references any more
+// is free, and acquire() hands it out again reset to an empty chunk. Its mesh
+// buffers keep their capacity too, so once the pool has grown to cover the
+// view distance, loading chunks doesn't touch the heap.
+//
+// Memory stays at the high-water mark until the pool is destroyed. Chunks
+// still referenced elsewhere when that happens stay valid, every chunk keeps
+// its slab alive.
+//
+// Not thread safe - acquire from the thread that owns the World.
+
+#include "world/Chunk.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class ChunkPool {
+public:
+    static constexpr std::size_t SLAB_CHUNKS = 16; // ~2 MB per slab
+
+    ChunkPool() = default;
+
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    // An empty chunk at (chunkX, chunkZ), recycled if one is free
+    std::shared_ptr<Chunk> acquire(int chunkX, int chunkZ);
+
+    // Chunks the pool holds, in use or not
+    std::size_t getCapacity() const { return m_chunks.size(); }
+    std::size_t getSlabCount() const { return m_chunks.size() / SLAB_CHUNKS; }
+
+private:
+    struct Slab;
+
+    // Build another slab's worth of chunks
+    void grow();
+
+    // Every chunk ever built, the pool's reference is what keeps them around
+    std::vector<std::shared_ptr<Chunk>> m_chunks;
+    std::size_t m_cursor = 0; // where the search for a free chunk resumes
+};
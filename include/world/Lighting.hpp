@@ -0,0 +1,90 @@
+#pragma once
+
+// LightEngine - sky light and block light for the World
+// Light is spread with a queue-based BFS flood fill that crosses chunk borders.
+// Block edits only relight the cells whose light actually changes: the old light
+// is flooded out (removal pass) and the surrounding light flooded back in.
+// Light falls off by at least 1 per block, so any update stays within 15 blocks
+// horizontally of where it started, i.e. inside the 3x3 chunks around it.
+
+#include "world/ChunkNeighborhood.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class World;
+
+class LightEngine {
+public:
+    explicit LightEngine(World& world) : m_world(world) {}
+
+    // Light a freshly generated chunk (already in the world's chunk map)
+    // and exchange light with the loaded chunks around it
+    void lightChunk(Chunk& chunk) {
+        lightColumns(chunk);
+        spreadChunk(chunk);
+    }
+
+    // First half of lightChunk(): sky light straight down each column
+    // Only touches this one chunk, so it's safe to run on several chunks in parallel
+    static void lightColumns(Chunk& chunk);
+
+    // Second half: flood sky and block light sideways, into and out of the neighbors
+    // When loading a batch, light all the columns first so no chunk floods
+    // into a neighbor that hasn't had its sky light yet
+    void spreadChunk(Chunk& chunk);
+
+    // Fix up light after the block at world (x, y, z) changed
+    void onBlockChanged(int x, int y, int z);
+
+    // Same for a batch of changed blocks, taken out of blocks as they're done
+    // All of a chunk's blocks share one removal and one refill, so blocks
+    // close together don't each redo the light around them. maxChunks > 0
+    // stops after that many chunks (in the order they first show up) and
+    // leaves the other blocks in blocks, in order, for a later call
+    void onBlocksChanged(std::vector<glm::ivec3>& blocks, std::size_t maxChunks = 0);
+
+private:
+    // Queue entries are cells relative to the neighborhood origin:
+    // x in bits 0-5, z in bits 6-11, y in bits 12-19, light level in bits 20-23
+    static uint32_t pack(int x, int y, int z, uint8_t level = 0) {
+        return static_cast<uint32_t>(x) | (static_cast<uint32_t>(z) << 6) |
+               (static_cast<uint32_t>(y) << 12) | (static_cast<uint32_t>(level) << 20);
+    }
+
+    // Center the working neighborhood on a chunk (no-op if it already is)
+    void focus(int chunkX, int chunkZ);
+
+    // Flag the chunk holding a changed cell for a remesh, plus the chunk
+    // next to it if the cell is on the border (its faces sample this cell)
+    void markChanged(int x, int z);
+
+    template <bool Sky> uint8_t read(int x, int y, int z) const;
+    template <bool Sky> void write(int x, int y, int z, uint8_t level);
+
+    // Spread light from every cell in m_addQueue
+    template <bool Sky> void propagate();
+    // Take away light from every cell in m_removeQueue. Brighter cells found
+    // at the edge of the removed area go into m_addQueue to refill it
+    template <bool Sky> void unpropagate();
+
+    // Relight changed blocks in any chunks (sorted and deduplicated in place)
+    void relightChunks(std::vector<glm::ivec3>& blocks);
+    // Relight changed blocks, all in the same chunk
+    void relightBlocks(const glm::ivec3* blocks, std::size_t count);
+    template <bool Sky> void relight(const glm::ivec3* blocks, std::size_t count);
+
+    // Push the lit cells of the center chunk's neighbors that touch it
+    template <bool Sky> void seedFromNeighbors();
+
+    World& m_world;
+    ChunkNeighborhood m_area;
+
+    // Kept between calls so steady-state relighting doesn't allocate
+    std::vector<uint32_t> m_addQueue;
+    std::vector<uint32_t> m_removeQueue;
+    std::vector<std::pair<int, int>> m_picked; // onBlocksChanged()'s chunks this call
+    std::vector<glm::ivec3> m_batch;           // and their blocks
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+// Player - walking controller with an AABB that collides with the voxel grid
+// Runs at a fixed tick rate (see TICK_RATE), independent of the frame rate.
+// Same inputs from the same start position always give the same trajectory.
+
+#include "world/ChunkNeighborhood.hpp"
+#include <glm/glm.hpp>
+
+class World;
+
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// What the player wants to do for one tick
+struct PlayerInput {
+    float forward = 0.0f; // -1..1, along the look direction (flattened)
+    float strafe = 0.0f;  // -1..1, positive is right
+    bool jump = false;
+    float yaw = -90.0f;   // degrees, same convention as Camera
+};
+
+class Player {
+public:
+    static constexpr int TICK_RATE = 60;                    // ticks per second
+    static constexpr float TICK_DT = 1.0f / TICK_RATE;
+
+    static constexpr float WIDTH = 0.6f;
+    static constexpr float HEIGHT = 1.8f;
+    static constexpr float EYE_HEIGHT = 1.62f;
+    static constexpr float STEP_HEIGHT = 0.6f;              // ledges up to this high are walked onto
+
+    static constexpr float WALK_SPEED = 4.3f;               // blocks/s
+    static constexpr float JUMP_VELOCITY = 8.9f;            // ~1.25 block jump
+    static constexpr float GRAVITY = 32.0f;                 // blocks/s^2
+    static constexpr float TERMINAL_VELOCITY = 78.0f;
+    static constexpr float AIR_CONTROL = 0.1f;              // fraction of the velocity change applied per tick in the air
+
+    // position is the center of the player's feet
+    explicit Player(const glm::vec3& position = glm::vec3(0.0f));
+
+    // Advance one fixed tick
+    void tick(World& world, const PlayerInput& input);
+
+    void setPosition(const glm::vec3& position);
+    glm::vec3 getPosition() const { return m_position; }
+    // Position at the start of the current tick, for interpolating between ticks
+    glm::vec3 getPreviousPosition() const { return m_prevPosition; }
+    glm::vec3 getEyePosition() const { return m_position + glm::vec3(0.0f, EYE_HEIGHT, 0.0f); }
+    glm::vec3 getVelocity() const { return m_velocity; }
+    bool isOnGround() const { return m_onGround; }
+
+    AABB getBounds() const { return boundsAt(m_position); }
+
+private:
+    static AABB boundsAt(const glm::vec3& position);
+
+    // Block cell is solid for collision
+    // Unloaded chunks count as solid so nothing falls out of the world while it streams in
+    bool isSolidAt(int x, int y, int z) const;
+
+    // Clip a movement of `delta` along one axis so box doesn't enter any solid block
+    float clipAxis(const AABB& box, int axis, float delta) const;
+
+    // Move box by delta, resolving one axis at a time (Y, then X, then Z)
+    // Returns the movement that actually happened
+    glm::vec3 sweep(AABB& box, const glm::vec3& delta) const;
+
+    glm::vec3 m_position;
+    glm::vec3 m_prevPosition;
+    glm::vec3 m_velocity = glm::vec3(0.0f);
+    bool m_onGround = false;
+
+    // Chunks around the player, refreshed when the player changes chunk
+    // or the world loads/unloads chunks
+    ChunkNeighborhood m_chunks;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+// Types for voxel ray queries against the World
+// See World::raycast / World::raycastBatch
+
+#include "world/Block.hpp"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Block faces, same order the chunk mesher emits them in
+enum class BlockFace : uint8_t {
+    NEG_X = 0,
+    POS_X,
+    NEG_Z,
+    POS_Z,
+    NEG_Y,
+    POS_Y,
+    NONE // ray started inside the block
+};
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;   // doesn't need to be normalized
+    float maxDistance = 8.0f;
+};
+
+struct RaycastHit {
+    bool hit = false;
+    glm::ivec3 block = glm::ivec3(0);  // world block coords of the hit block
+    glm::ivec3 normal = glm::ivec3(0); // outward normal of the face that was hit
+    BlockFace face = BlockFace::NONE;
+    BlockType type = BlockType::AIR;
+    float distance = 0.0f;             // distance along the (normalized) ray
+
+    // Cell in front of the hit face - where a placed block would go
+    glm::ivec3 adjacent() const { return block + normal; }
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+// Types for bulk edits of the World
+// See World::fillBox / replaceInBox / fillSphere / copyBox / paste
+
+#include "world/Block.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Box of blocks, min and max both inclusive
+struct BlockBox {
+    glm::ivec3 min = glm::ivec3(0);
+    glm::ivec3 max = glm::ivec3(-1);
+
+    BlockBox() = default;
+    // Corners in any order
+    BlockBox(const glm::ivec3& a, const glm::ivec3& b)
+        : min(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)),
+          max(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)) {}
+
+    bool empty() const { return max.x < min.x || max.y < min.y || max.z < min.z; }
+    glm::ivec3 size() const { return max - min + glm::ivec3(1); }
+    uint64_t volume() const {
+        if (empty()) return 0;
+        glm::ivec3 s = size();
+        return static_cast<uint64_t>(s.x) * s.y * s.z;
+    }
+};
+
+// Blocks copied out of the world by World::copyBox, laid out like chunk
+// storage: x fastest, then z, then y
+class Clipboard {
+public:
+    Clipboard() = default;
+    explicit Clipboard(const glm::ivec3& size)
+        : m_size(size), m_blocks(static_cast<std::size_t>(size.x) * size.y * size.z, BlockType::AIR) {}
+
+    const glm::ivec3& getSize() const { return m_size; }
+    bool empty() const { return m_blocks.empty(); }
+
+    BlockType get(int x, int y, int z) const { return m_blocks[index(x, y, z)]; }
+    void set(int x, int y, int z, BlockType type) { m_blocks[index(x, y, z)] = type; }
+
+    // The m_size.x blocks of one row
+    BlockType* row(int y, int z) { return &m_blocks[index(0, y, z)]; }
+    const BlockType* row(int y, int z) const { return &m_blocks[index(0, y, z)]; }
+
+private:
+    std::size_t index(int x, int y, int z) const {
+        return (static_cast<std::size_t>(y) * m_size.z + z) * m_size.x + x;
+    }
+
+    glm::ivec3 m_size = glm::ivec3(0);
+    std::vector<BlockType> m_blocks;
+};
+
+// What a bulk edit did. Spreading the light and remeshing happen over the
+// next World::update()s, once per changed chunk (and per neighbor whose light
+// or border faces changed)
+struct EditStats {
+    uint64_t blocksChanged = 0;
+    std::size_t chunksChanged = 0; // chunks with at least one changed block
+    std::size_t chunksRelit = 0;   // changed chunks plus their loaded neighbors
+    double editMs = 0.0;           // writing the blocks
+    double lightMs = 0.0;          // clearing the light and lighting the columns
+};
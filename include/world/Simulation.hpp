@@ -0,0 +1,59 @@
+#pragma once
+
+// Simulation - a World plus everyone in it, advanced at a fixed tick rate
+// Players walk with full collision; viewers are bare positions (spectators,
+// remote cameras) that only keep chunks loaded. No window or GL anywhere,
+// this is what a dedicated server runs (see src/headless.cpp).
+
+#include "world/Player.hpp"
+#include "world/World.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Simulation {
+public:
+    static constexpr int TICK_RATE = Player::TICK_RATE;
+    static constexpr float TICK_DT = Player::TICK_DT;
+
+    // Servers run HEADLESS, nobody is going to look at the meshes
+    Simulation(int seed, int viewDistance, WorldMode mode = WorldMode::HEADLESS);
+
+    // Spawn a player on the ground at world column (x, z), returns its id
+    // Loads the chunks around the spawn point if they aren't yet
+    std::size_t addPlayer(int x, int z);
+    void setInput(std::size_t player, const PlayerInput& input) { m_inputs[player] = input; }
+    const Player& getPlayer(std::size_t player) const { return m_players[player]; }
+    std::size_t getPlayerCount() const { return m_players.size(); }
+
+    // Viewers load chunks around them but don't collide or fall
+    // Ids of removed viewers get handed out again by addViewer()
+    std::size_t addViewer(const glm::vec3& position);
+    void removeViewer(std::size_t viewer);
+    void setViewerPosition(std::size_t viewer, const glm::vec3& position) { m_viewers[viewer] = position; }
+    const glm::vec3& getViewerPosition(std::size_t viewer) const { return m_viewers[viewer]; }
+    std::size_t getViewerCount() const { return m_viewers.size(); }
+
+    // Advance one tick: block ticks (water, grass), move every player, then
+    // stream chunks around everybody (which also remeshes edited chunks when
+    // meshing is on)
+    void tick();
+
+    World& getWorld() { return m_world; }
+    const World& getWorld() const { return m_world; }
+    uint64_t getTickCount() const { return m_tickCount; }
+    int getViewDistance() const { return m_viewDistance; }
+
+private:
+    World m_world;
+    int m_viewDistance;
+
+    std::vector<Player> m_players;
+    std::vector<PlayerInput> m_inputs;
+    std::vector<glm::vec3> m_viewers;
+    std::vector<bool> m_viewerActive;
+
+    std::vector<glm::vec3> m_positions; // players + viewers, reused every tick
+    uint64_t m_tickCount = 0;
+};
@@ -1,44 +1,264 @@
 #pragma once
 
 // Manages all chunks and the world's terrain
-// Generates terrain using perlin noise and handles chunk loading/unloading
-// based on where the camera is looking
+// Generates terrain (see WorldGenerator) and handles chunk loading/unloading
+// based on where the camera (or, on a server, every player) is
+// No GL in here - drawing is WorldRenderer's job
 
+#include "core/ThreadPool.hpp"
+#include "world/BlockTicks.hpp"
 #include "world/Chunk.hpp"
+#include "world/ChunkPool.hpp"
+#include "world/Lighting.hpp"
+#include "world/Raycast.hpp"
+#include "world/RegionEdit.hpp"
+#include "world/WorldGenerator.hpp"
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
+#include <utility>
+#include <vector>
+
+// Where chunks come from and whether they get meshed
+enum class WorldMode {
+    LOCAL,    // generated here, meshed for rendering (single player)
+    HEADLESS, // generated here, never meshed (servers, load tests)
+    REMOTE,   // received from a server through addChunks(), meshed (network client)
+};
+
+// Running totals of the world's streaming work, for benchmarks and replays
+// Times are wall-clock ms on the calling thread (parallel phases count once)
+struct WorldStats {
+    uint64_t chunksLoaded = 0;
+    uint64_t chunksUnloaded = 0;
+    uint64_t meshesBuilt = 0;
+    double generateMs = 0.0;
+    double lightMs = 0.0;   // light for newly loaded chunks and bulk edits, not setBlock()
+    double meshMs = 0.0;
+
+    // Block ticks (see tick())
+    uint64_t blockUpdates = 0;   // scheduled updates run
+    uint64_t randomTickHits = 0; // random ticks that landed on a block that reacts
+    uint64_t tickChanges = 0;    // blocks changed by either
+    double tickMs = 0.0;         // including the light updates, not the remeshing
+};
 
 class World {
 public:
     // Create world with optional seed (default seed works fine)
-    explicit World(int seed = 12345);
+    explicit World(int seed = 12345, WorldMode mode = WorldMode::LOCAL);
 
     // Update which chunks to keep loaded - call every frame
-    // Loads chunks near camera, unloads distant ones
+    // Loads chunks near camera, unloads distant ones. A REMOTE world leaves
+    // that to its server and only remeshes edited chunks
     void update(const glm::vec3& cameraPos, int renderDistance = 4);
 
-    // Render all the loaded chunks
-    void render(unsigned int shaderProgram) const;
+    // Same for any number of viewers: keeps the union of their squares loaded
+    // Chunks are dropped once they're more than renderDistance + 1 from every
+    // viewer, so walking back and forth over a border doesn't reload them
+    void update(const std::vector<glm::vec3>& viewers, int renderDistance = 4);
+
+    // Advance block ticks by one: flowing water, grass, ... (see BlockTicks)
+    // Call at Player::TICK_RATE. The blocks it changes are relit at the end
+    // of the tick, at most LIGHT_CHUNKS_PER_TICK chunks of them, the rest on
+    // the following ticks. Each chunk is remeshed once by the update() after
+    // its light is done
+    void tick();
+    BlockTicks& getBlockTicks() { return m_ticks; }
+    const BlockTicks& getBlockTicks() const { return m_ticks; }
+    // Blocks changed by ticks whose light is still to be updated
+    std::size_t getPendingLightUpdates() const { return m_deferredLight.size(); }
+
+    // Chunks a tick relights at most, see tick()
+    static constexpr std::size_t LIGHT_CHUNKS_PER_TICK = 4;
+
+    // Most chunks one update() loads, nearest to a viewer first, the rest
+    // come in over the following updates. 0 = no limit (the default)
+    void setLoadLimit(std::size_t chunks) { m_loadLimit = chunks; }
+    std::size_t getLoadLimit() const { return m_loadLimit; }
+    // Chunks in range the last update() left for later because of the limit
+    std::size_t getPendingLoads() const { return m_pendingLoads; }
+
+    // Most chunks one update() spreads the light of after bulk edits, 0 = all
+    // of them. Separate from the load limit: that one drops to a single chunk
+    // on slow frames, which would leave a big edit unmeshed for seconds
+    void setRelightLimit(std::size_t chunks) { m_relightLimit = chunks; }
+    std::size_t getRelightLimit() const { return m_relightLimit; }
+    // Chunks a bulk edit left waiting for their light (and remesh)
+    std::size_t getPendingRelights() const { return m_relightQueue.size(); }
+
+    static constexpr std::size_t RELIGHTS_PER_UPDATE = 4;
+
+    // Visit every loaded chunk, fn(Chunk&)
+    template <typename Fn>
+    void forEachChunk(Fn&& fn) const {
+        for (const auto& [key, chunk] : m_chunks) fn(*chunk);
+    }
+    std::size_t getChunkCount() const { return m_chunks.size(); }
 
     // Get or create chunk at these coordinates
+    // A REMOTE world can't create chunks, it returns nullptr for unloaded ones
     std::shared_ptr<Chunk> getOrCreateChunk(int chunkX, int chunkZ);
 
+    // Add chunks whose blocks were filled in elsewhere (e.g. received from a server)
+    // Replaces any loaded chunk at the same coords. Lights and meshes them like
+    // freshly generated ones
+    void addChunks(const std::vector<std::shared_ptr<Chunk>>& chunks);
+
+    // Where this world's chunks come from. Chunks for addChunks() should be
+    // taken from here too, so unloaded ones get recycled
+    ChunkPool& getChunkPool() { return m_pool; }
+
+    // Drop one chunk, false if it wasn't loaded
+    bool removeChunk(int chunkX, int chunkZ);
+
+    int getSeed() const { return m_seed; }
+    WorldMode getMode() const { return m_mode; }
+
+    // Layout of the chunk meshes handed to the renderer
+    // Changing it remeshes every loaded chunk on the next update()
+    void setMeshFormat(MeshFormat format);
+    MeshFormat getMeshFormat() const { return m_meshFormat; }
+
+    const WorldStats& getStats() const { return m_stats; }
+
+    // Get a loaded chunk without creating it, nullptr if it isn't loaded
+    Chunk* findChunk(int chunkX, int chunkZ) const;
+
+    // Bumped whenever a chunk is loaded or unloaded, so anyone caching
+    // chunk pointers (see ChunkNeighborhood) knows when to look them up again
+    uint64_t getChunkEpoch() const { return m_chunkEpoch; }
+
+    // Block access in world block coords
+    // Unloaded chunks and out of range y read as AIR
+    BlockType getBlock(int x, int y, int z) const;
+    // Returns false if the chunk isn't loaded. Light is updated right away, the chunk
+    // (and any neighbors whose light or AO changed) get remeshed on the next update()
+    // Water next to it is woken up
+    bool setBlock(int x, int y, int z, BlockType type);
+
+    // Bulk edits, world block coords
+    // Only loaded chunks are touched, y is clipped to the world. The work is
+    // split into (chunk, section) pieces that run on the worker pool and write
+    // whole rows straight into chunk storage. Afterwards the changed chunks and
+    // their neighbors get their light redone: cleared and lit straight down
+    // right away, spread sideways and remeshed over the next update()s, a few
+    // chunks each (see setRelightLimit()), so a big edit doesn't stall a frame.
+    // Use setBlock() for one-off blocks, it only relights around the block
+    EditStats fillBox(const BlockBox& box, BlockType type);
+    // Every block of type from in the box becomes to
+    EditStats replaceInBox(const BlockBox& box, BlockType from, BlockType to);
+    // Blocks whose center is within radius of center's
+    EditStats fillSphere(const glm::ivec3& center, int radius, BlockType type);
+    // Blocks of the box, unloaded chunks read as AIR
+    Clipboard copyBox(const BlockBox& box) const;
+    // Clipboard's (0, 0, 0) goes to origin. skipAir leaves the world's blocks
+    // where the clipboard has AIR
+    EditStats paste(const Clipboard& clipboard, const glm::ivec3& origin, bool skipAir = false);
+
+    // Step through the voxel grid (Amanatides-Woo DDA) until a solid block is hit
+    // Only looks up the chunk map when the ray crosses a chunk border, never allocates
+    RaycastHit raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const;
+
+    // Same as raycast() for many rays at once, hits[i] is the result for rays[i]
+    // The chunk cursor is shared between rays, so coherent rays skip most lookups
+    void raycastBatch(const Ray* rays, std::size_t count, RaycastHit* hits) const;
+
+    // World block coords -> chunk coords (floor division, works for negatives)
+    static int toChunkCoord(int block, int chunkSize) {
+        return block >= 0 ? block / chunkSize : (block + 1) / chunkSize - 1;
+    }
+
 private:
-    // Populate a chunk with terrain blocks
-    void generateTerrain(std::shared_ptr<Chunk> chunk);
+    // Create, generate, light and mesh a batch of chunks that aren't loaded yet
+    // Generation and meshing run on the worker pool, lighting on this thread
+    void loadChunks(const std::vector<std::pair<int, int>>& coords);
+
+    // Remesh chunks whose blocks changed since their last mesh
+    void rebuildDirtyMeshes();
+
+    // Run edit on the part of box inside each loaded chunk, one call per
+    // (chunk, section) and in parallel. local is in chunk-local coords and
+    // within one section; edit returns how many blocks it changed
+    using SectionEdit = std::function<uint64_t(Chunk& chunk, const BlockBox& local)>;
+    EditStats editBox(const BlockBox& box, const SectionEdit& edit);
+
+    // The part of a box inside one section of one loaded chunk, chunk-local coords
+    struct BoxPiece {
+        Chunk* chunk;
+        BlockBox local;
+    };
+    // Pieces of the same chunk come out next to each other
+    void splitBox(const BlockBox& box, std::vector<BoxPiece>& pieces) const;
+
+    // Redo light from scratch for the changed chunks and the ring around them
+    // (light travels at most 15 blocks, so nothing further out can change):
+    // clears it and lights the columns, and queues the chunks for
+    // drainRelights(). Returns how many chunks were queued
+    std::size_t relightChunks(const std::vector<Chunk*>& changed);
+    // Spread the light of queued chunks and flag them for a remesh, up to
+    // the relight limit per call
+    void drainRelights();
+    // The chunk or one around it is in m_waitingForLight
+    bool waitingForLight(int chunkX, int chunkZ) const;
 
-    // Simple noise function for terrain generation
-    // (simplified for demo - would use proper perlin in production)
-    float getNoise(float x, float z) const;
+    // Both update()s, without building a vector for a single viewer
+    void updateViewers(const glm::vec3* viewers, std::size_t count, int renderDistance);
+
+    // Drop chunks that are far from every viewer chunk
+    void unloadChunks(const std::vector<std::pair<int, int>>& viewerChunks, int keepDistance);
+
+    using ChunkMap = std::map<int64_t, std::shared_ptr<Chunk>>;
+
+    // Map insert/erase that keep the map's nodes for reuse instead of freeing them
+    void insertChunk(const std::shared_ptr<Chunk>& chunk);
+    ChunkMap::iterator eraseChunk(ChunkMap::iterator it);
 
     int m_seed; // for reproducible terrain generation
+    WorldMode m_mode;
+    MeshFormat m_meshFormat = MeshFormat::VERTICES;
+    WorldGenerator m_generator;
+    mutable ThreadPool m_workers; // copyBox() fans out too
+
+    // Declared before m_chunks so it outlives them
+    ChunkPool m_pool;
 
     // chunks stored by encoded coords (chunkX, chunkZ)
-    std::map<int64_t, std::shared_ptr<Chunk>> m_chunks;
+    ChunkMap m_chunks;
+    std::vector<ChunkMap::node_type> m_freeNodes;
+
+    uint64_t m_chunkEpoch = 0;
+    WorldStats m_stats;
+
+    // Keeps sky/block light up to date as chunks load and blocks change
+    LightEngine m_lighting{*this};
+
+    // Scheduled and random block updates, see tick()
+    BlockTicks m_ticks{*this, static_cast<uint32_t>(m_seed)};
+    // While ticking, setBlock() leaves the light to the end of the tick
+    bool m_deferLight = false;
+    std::vector<glm::ivec3> m_deferredLight; // oldest first
+
+    // Viewer chunks and distance from the last update(), nothing to do until
+    // one of them changes (or there are chunks left to load)
+    std::vector<std::pair<int, int>> m_viewerChunks;
+    int m_renderDistance = -1;
+    std::size_t m_loadLimit = 0;
+    std::size_t m_pendingLoads = 0;
+
+    // Chunks relit by bulk edits whose light still has to spread (sorted)
+    std::vector<std::pair<int, int>> m_relightQueue;
+    std::size_t m_relightLimit = RELIGHTS_PER_UPDATE;
 
-    int m_centerChunkX = 0;
-    int m_centerChunkZ = 0;
+    // Scratch for update() and friends, kept so steady-state streaming doesn't allocate
+    std::vector<std::pair<int, int>> m_nextViewerChunks;
+    std::vector<std::pair<int, int>> m_missing;
+    std::vector<int64_t> m_keep;
+    std::vector<std::shared_ptr<Chunk>> m_created;
+    std::vector<Chunk*> m_dirty;
+    std::vector<std::pair<int, int>> m_waitingForLight; // chunks, sorted, see rebuildDirtyMeshes()
 
     // Pack chunk coords into single key for the map
     static int64_t encodeChunkKey(int chunkX, int chunkZ) {
@@ -0,0 +1,69 @@
+#pragma once
+
+// WorldGenerator - fills chunks with terrain, one stage at a time
+//
+//   BASE     stone / dirt / grass from the heightmap
+//   CARVE    caves carved out of the base terrain
+//   SURFACE  sand beaches and water up to sea level
+//   FEATURES trees (and other decorations) - these can spill into neighbors
+//
+// Every stage only reads pure functions of (seed, world position): the heightmap,
+// the cave density and the feature placements. A stage that needs its neighbors
+// says so in NEIGHBOR_RADIUS; FEATURES looks one chunk out to pick up trees
+// rooted next door, recomputing their placement rather than reading the neighbor's
+// blocks. So no chunk ever waits on another chunk's data - any set of chunks can
+// be generated in parallel, in any order, and the output only depends on the seed.
+
+#include "world/Chunk.hpp"
+#include <cstdint>
+
+class WorldGenerator {
+public:
+    enum Stage { BASE, CARVE, SURFACE, FEATURES, STAGE_COUNT };
+
+    // How far out (in chunks) each stage reads placement data from
+    static constexpr int NEIGHBOR_RADIUS[STAGE_COUNT] = { 0, 0, 0, 1 };
+
+    static constexpr int SEA_LEVEL = 38;
+
+    explicit WorldGenerator(int seed);
+
+    // Run every stage on a freshly created (all AIR) chunk
+    // const and stateless, so it's safe to call from several threads at once
+    void generate(Chunk& chunk) const;
+
+    // Run a single stage, stages have to run in order
+    void runStage(Stage stage, Chunk& chunk) const;
+
+    // y of the topmost block of the base terrain at world column (x, z)
+    int getSurfaceHeight(int x, int z) const;
+
+private:
+    struct Tree {
+        int x, y, z;   // world coords of the trunk's bottom block
+        int height;    // trunk height
+    };
+    static constexpr int MAX_TREES_PER_CHUNK = 4;
+
+    void generateBase(Chunk& chunk) const;
+    void carveCaves(Chunk& chunk) const;
+    void decorateSurface(Chunk& chunk) const;
+    void placeFeatures(Chunk& chunk) const;
+
+    // Trees rooted in chunk (chunkX, chunkZ), returns how many were written to out
+    int findTrees(int chunkX, int chunkZ, Tree* out) const;
+
+    // Simple noise function for terrain generation
+    // (simplified for demo - would use proper perlin in production)
+    float getNoise(float x, float z) const;
+
+    // 3D gradient noise in about -1..1
+    float gradientNoise(float x, float y, float z, uint32_t salt) const;
+
+    // Cave density at a world position, carved where it's below zero
+    float caveDensity(float x, float y, float z) const;
+
+    uint32_t hash(int x, int y, int z, uint32_t salt) const;
+
+    int m_seed;
+};
@@ -46,6 +46,12 @@ void Camera::processMouse(float xoffset, float yoffset, bool constrainPitch) {
     updateCameraVectors();
 }
 
+void Camera::setOrientation(float yaw, float pitch) {
+    Yaw = yaw;
+    Pitch = pitch;
+    updateCameraVectors();
+}
+
 void Camera::updateCameraVectors() {
     glm::vec3 front;
     front.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
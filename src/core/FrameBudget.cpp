@@ -0,0 +1,118 @@
+#include "core/FrameBudget.hpp"
+#include <algorithm>
+#include <iostream>
+
+FrameBudget::FrameBudget(double targetMs, int startDistance, int maxDistance)
+    : m_targetMs(targetMs),
+      m_distance(std::max(startDistance, MIN_DISTANCE)),
+      m_maxDistance(std::max(maxDistance, MIN_DISTANCE)) {
+    m_distance = std::min(m_distance, m_maxDistance);
+    decide("start", true);
+}
+
+bool FrameBudget::endFrame(double frameMs, std::size_t backlog) {
+    ++m_frame;
+    ++m_sinceChange;
+    m_window[m_next] = frameMs;
+    m_next = (m_next + 1) % WINDOW;
+    m_count = std::min(m_count + 1, WINDOW);
+
+    // Streaming limits react to every frame
+    const char* reason = nullptr;
+    if (frameMs > m_targetMs) {
+        if (m_uploadLimit > MIN_UPLOADS || m_loadLimit > MIN_LOADS) {
+            m_uploadLimit = std::max(m_uploadLimit / 2, MIN_UPLOADS);
+            m_loadLimit = std::max(m_loadLimit / 2, MIN_LOADS);
+            reason = "slow frame, less streaming per frame";
+        }
+    } else if (frameMs < 0.75 * m_targetMs && backlog > 0) {
+        if (m_uploadLimit < MAX_UPLOADS || m_loadLimit < MAX_LOADS) {
+            m_uploadLimit = std::min(m_uploadLimit + 2, MAX_UPLOADS);
+            m_loadLimit = std::min(m_loadLimit + 1, MAX_LOADS);
+            reason = "frames to spare, more streaming per frame";
+        }
+    }
+
+    // Render distance only looks at a full window, all of it at this distance
+    bool distanceChanged = false;
+    if (m_count == WINDOW) {
+        double sum = 0.0;
+        for (double ms : m_window) sum += ms;
+        double mean = sum / WINDOW;
+        bool streamingAtMinimum = m_uploadLimit == MIN_UPLOADS && m_loadLimit == MIN_LOADS;
+
+        // Over budget with nothing left to cut from streaming: the world is too big
+        if (mean > m_targetMs && (backlog == 0 || streamingAtMinimum) && m_distance > MIN_DISTANCE) {
+            // A raise that didn't hold makes the next one wait longer
+            if (m_lastWasRaise && m_sinceChange < m_raiseWait) {
+                m_raiseWait = std::min(m_raiseWait * 2, MAX_RAISE_WAIT);
+            } else {
+                m_raiseWait = RAISE_WAIT;
+            }
+            --m_distance;
+            m_lastWasRaise = false;
+            distanceChanged = true;
+            reason = "over budget, lower render distance";
+        } else if (backlog == 0 && m_distance < m_maxDistance && m_sinceChange >= m_raiseWait &&
+                   percentile90() < 0.7 * m_targetMs) {
+            ++m_distance;
+            m_lastWasRaise = true;
+            distanceChanged = true;
+            reason = "under budget, raise render distance";
+        }
+    }
+
+    if (!reason) return false;
+    decide(reason, distanceChanged);
+    if (distanceChanged) {
+        // Frames from before the change say nothing about the new distance
+        m_count = 0;
+        m_next = 0;
+        m_sinceChange = 0;
+    }
+    return true;
+}
+
+void FrameBudget::decide(const char* reason, bool distanceChanged) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < m_count; ++i) sum += m_window[i];
+
+    m_last.frame = m_frame;
+    m_last.meanMs = m_count ? sum / m_count : 0.0;
+    m_last.p90Ms = percentile90();
+    m_last.renderDistance = m_distance;
+    m_last.uploadLimit = m_uploadLimit;
+    m_last.loadLimit = m_loadLimit;
+    m_last.reason = reason;
+    if (distanceChanged) m_lastDistance = m_last;
+}
+
+double FrameBudget::percentile90() const {
+    if (m_count == 0) return 0.0;
+    std::array<double, WINDOW> sorted;
+    std::copy(m_window.begin(), m_window.begin() + m_count, sorted.begin());
+    std::size_t rank = (m_count * 9 + 9) / 10 - 1; // nearest rank, same as SampleStats
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + m_count);
+    return sorted[rank];
+}
+
+BudgetLog::~BudgetLog() {
+    if (m_file && m_file != stdout) std::fclose(m_file);
+}
+
+bool BudgetLog::open(const std::string& path) {
+    m_file = path == "-" ? stdout : std::fopen(path.c_str(), "w");
+    if (!m_file) {
+        std::cerr << "Can't write frame budget log " << path << std::endl;
+        return false;
+    }
+    std::fprintf(m_file, "frame,mean_ms,p90_ms,render_distance,upload_limit,load_limit,reason\n");
+    return true;
+}
+
+void BudgetLog::write(const BudgetDecision& d) {
+    if (!m_file) return;
+    std::fprintf(m_file, "%llu,%.2f,%.2f,%d,%zu,%zu,%s\n", static_cast<unsigned long long>(d.frame), d.meanMs,
+                 d.p90Ms, d.renderDistance, d.uploadLimit, d.loadLimit, d.reason);
+    std::fflush(m_file);
+}
@@ -0,0 +1,55 @@
+#include "core/Framebuffer.hpp"
+#include "core/MemoryTracker.hpp"
+#include <iostream>
+
+Framebuffer::~Framebuffer() {
+    release();
+}
+
+bool Framebuffer::create(int width, int height) {
+    release();
+    m_width = width;
+    m_height = height;
+
+    // Renderbuffers, not textures - nothing samples the result
+    glGenRenderbuffers(1, &m_color);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+
+    // Both attachments are 4 bytes a pixel (depth24 is stored padded to 32 bits)
+    MemoryTracker::add(MemoryCategory::GL_OBJECTS, 2 * renderbufferBytes(), 3);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Framebuffer incomplete (status 0x" << std::hex << status << std::dec << ")" << std::endl;
+        release();
+        return false;
+    }
+    return true;
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void Framebuffer::release() {
+    if (m_fbo) {
+        glDeleteFramebuffers(1, &m_fbo);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, -2 * renderbufferBytes(), -3);
+    }
+    if (m_color) glDeleteRenderbuffers(1, &m_color);
+    if (m_depth) glDeleteRenderbuffers(1, &m_depth);
+    m_fbo = m_color = m_depth = 0;
+}
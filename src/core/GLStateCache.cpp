@@ -0,0 +1,34 @@
+#include "core/GLStateCache.hpp"
+
+bool GLStateCache::change(GLuint& current, GLuint wanted) {
+    if (current == wanted) {
+        if (m_stats) ++m_stats->redundantStateChanges;
+        return false;
+    }
+    current = wanted;
+    if (m_stats) ++m_stats->stateChanges;
+    return true;
+}
+
+void GLStateCache::useProgram(GLuint program) {
+    if (change(m_program, program)) glUseProgram(program);
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (change(m_vao, vao)) glBindVertexArray(vao);
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint& current = target == GL_ARRAY_BUFFER ? m_arrayBuffer
+                    : target == GL_TEXTURE_BUFFER ? m_textureBuffer
+                    : m_uniformBuffer;
+    if (change(current, buffer)) glBindBuffer(target, buffer);
+}
+
+void GLStateCache::bindBufferTexture(GLuint texture) {
+    if (change(m_bufferTexture, texture)) glBindTexture(GL_TEXTURE_BUFFER, texture);
+}
+
+void GLStateCache::invalidate() {
+    m_program = m_vao = m_arrayBuffer = m_textureBuffer = m_uniformBuffer = m_bufferTexture = UNKNOWN;
+}
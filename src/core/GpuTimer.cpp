@@ -0,0 +1,45 @@
+#include "core/GpuTimer.hpp"
+#include "core/MemoryTracker.hpp"
+
+GpuTimer::~GpuTimer() {
+    if (!m_queries[0]) return;
+    glDeleteQueries(RING_SIZE, m_queries.data());
+    MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, -RING_SIZE);
+}
+
+void GpuTimer::begin() {
+    if (!m_queries[0]) {
+        glGenQueries(RING_SIZE, m_queries.data());
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, RING_SIZE);
+    }
+
+    // Pick up whatever finished, and make room if every slot is still in flight
+    while (m_pending > 0 && collect(false)) {}
+    if (m_pending == RING_SIZE) collect(true);
+
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_next]);
+}
+
+void GpuTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_next = (m_next + 1) % RING_SIZE;
+    ++m_pending;
+}
+
+void GpuTimer::finish() {
+    while (m_pending > 0) collect(true);
+}
+
+bool GpuTimer::collect(bool wait) {
+    GLuint query = m_queries[(m_next - m_pending + RING_SIZE) % RING_SIZE];
+    if (!wait) {
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+    GLuint64 ns = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+    m_samples.add(ns / 1.0e6);
+    --m_pending;
+    return true;
+}
@@ -0,0 +1,112 @@
+#include "core/MemoryTracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+namespace {
+    constexpr std::size_t CATEGORY_COUNT = static_cast<std::size_t>(MemoryCategory::COUNT);
+
+    struct AtomicCounter {
+        std::atomic<int64_t> bytes{0};
+        std::atomic<int64_t> peakBytes{0};
+        std::atomic<int64_t> objects{0};
+        std::atomic<int64_t> peakObjects{0};
+        std::atomic<uint64_t> allocations{0};
+    };
+
+    AtomicCounter g_counters[CATEGORY_COUNT];
+
+    void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+        int64_t current = peak.load(std::memory_order_relaxed);
+        while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    const char* const NAMES[CATEGORY_COUNT] = { "blocks", "light", "mesh_cpu", "gpu_buffers", "gl_objects" };
+}
+
+const char* memoryCategoryName(MemoryCategory category) {
+    return NAMES[static_cast<std::size_t>(category)];
+}
+
+void MemoryTracker::add(MemoryCategory category, int64_t bytes, int64_t objects) {
+    AtomicCounter& c = g_counters[static_cast<std::size_t>(category)];
+    if (bytes != 0) {
+        raisePeak(c.peakBytes, c.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+    if (objects != 0) {
+        raisePeak(c.peakObjects, c.objects.fetch_add(objects, std::memory_order_relaxed) + objects);
+        if (objects > 0) c.allocations.fetch_add(static_cast<uint64_t>(objects), std::memory_order_relaxed);
+    }
+}
+
+MemorySnapshot MemoryTracker::snapshot() {
+    MemorySnapshot snapshot;
+    for (std::size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        const AtomicCounter& c = g_counters[i];
+        MemoryCounter& out = snapshot.counters[i];
+        out.bytes = c.bytes.load(std::memory_order_relaxed);
+        out.peakBytes = c.peakBytes.load(std::memory_order_relaxed);
+        out.objects = c.objects.load(std::memory_order_relaxed);
+        out.peakObjects = c.peakObjects.load(std::memory_order_relaxed);
+        out.allocations = c.allocations.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+int64_t MemorySnapshot::totalBytes() const {
+    int64_t total = 0;
+    for (const MemoryCounter& c : counters) total += c.bytes;
+    return total;
+}
+
+void MemorySnapshot::print(std::ostream& out) const {
+    constexpr double MB = 1024.0 * 1024.0;
+    for (std::size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        const MemoryCounter& c = counters[i];
+        out << "  " << NAMES[i] << ": " << c.bytes / MB << " MB (peak " << c.peakBytes / MB << "), "
+            << c.objects << " objects (peak " << c.peakObjects << ", " << c.allocations << " allocated)\n";
+    }
+    out << "  total: " << totalBytes() / MB << " MB\n";
+}
+
+MemoryLog::~MemoryLog() {
+    if (m_file && m_file != stdout) std::fclose(m_file);
+}
+
+bool MemoryLog::open(const std::string& path, double intervalSeconds) {
+    m_file = path == "-" ? stdout : std::fopen(path.c_str(), "w");
+    if (!m_file) {
+        std::cerr << "Can't write memory log " << path << std::endl;
+        return false;
+    }
+    m_interval = intervalSeconds;
+    m_start = std::chrono::steady_clock::now();
+    m_next = m_start;
+
+    std::fprintf(m_file, "seconds");
+    for (const char* name : NAMES) std::fprintf(m_file, ",%s_bytes,%s_peak_bytes,%s_objects", name, name, name);
+    std::fprintf(m_file, "\n");
+    return true;
+}
+
+void MemoryLog::update() {
+    auto now = std::chrono::steady_clock::now();
+    if (!m_file || now < m_next) return;
+    write();
+    // After a long stall, carry on one interval from now rather than writing a burst of lines
+    auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(m_interval));
+    m_next = std::max(m_next + step, now + step);
+}
+
+void MemoryLog::write() {
+    if (!m_file) return;
+    MemorySnapshot snapshot = MemoryTracker::snapshot();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    std::fprintf(m_file, "%.1f", seconds);
+    for (const MemoryCounter& c : snapshot.counters) {
+        std::fprintf(m_file, ",%lld,%lld,%lld", static_cast<long long>(c.bytes),
+                     static_cast<long long>(c.peakBytes), static_cast<long long>(c.objects));
+    }
+    std::fprintf(m_file, "\n");
+    std::fflush(m_file);
+}
@@ -0,0 +1,57 @@
+#include "core/OffscreenContext.hpp"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <iostream>
+
+OffscreenContext::~OffscreenContext() {
+    if (!m_display) return;
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_context) eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+}
+
+bool OffscreenContext::create() {
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay) {
+        std::cerr << "EGL: eglGetPlatformDisplayEXT not available" << std::endl;
+        return false;
+    }
+
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        std::cerr << "EGL: no surfaceless display (error 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        return false;
+    }
+    m_display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "EGL: desktop OpenGL not supported" << std::endl;
+        return false;
+    }
+
+    // Same version and profile the game window asks for
+    const EGLint attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE,
+    };
+    // No config and no surface: needs EGL_KHR_no_config_context and EGL_KHR_surfaceless_context
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attribs);
+    if (context == EGL_NO_CONTEXT) {
+        std::cerr << "EGL: failed to create a GL 3.3 core context (error 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        return false;
+    }
+    m_context = context;
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        std::cerr << "EGL: failed to make the context current" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+GLADloadproc OffscreenContext::getLoader() {
+    return (GLADloadproc)eglGetProcAddress;
+}
@@ -1,18 +1,27 @@
 #include "core/Renderer.hpp"
+#include "core/MemoryTracker.hpp"
+#include "world/Block.hpp"
 #include <glm/gtc/matrix_transform.hpp>
-#include <GLFW/glfw3.h>
+#include <cstddef>
 #include <iostream>
+#include <vector>
+
+// Camera matrices, shared by every program through one uniform buffer
+// std140: two column-major mat4s back to back, see CameraBlock
+const char* cameraBlockSource = R"(
+layout(std140) uniform Camera {
+    mat4 projection;
+    mat4 view;
+};
+)";
 
 // Vertex shader
 const char* vertexShaderSource = R"(
-#version 330 core
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 color;
 
 out vec3 vertexColor;
 
-uniform mat4 projection;
-uniform mat4 view;
 uniform mat4 model;
 
 void main()
@@ -34,18 +43,92 @@ void main()
 }
 )";
 
-Renderer::Renderer() : VAO(0), VBO(0), EBO(0), shaderProgram(0) {}
+// Face shader - draws MeshFormat::FACES meshes (see ChunkMeshData)
+// There are no vertex attributes: vertex 4 * i + c is corner c of face i
+// (WorldRenderer draws with a shared index buffer of such quads). The shader
+// reads the face's packed record out of a buffer texture and builds the
+// corner from it. FACE_COLOR_COUNT is defined in front of this when the
+// shader is built.
+const char* faceVertexShaderSource = R"(
+uniform usamplerBuffer faces;
+uniform ivec2 chunkOrigin; // world block coords of the chunk's (0, 0) column
+uniform vec3 faceColors[FACE_COLOR_COUNT]; // [block type * 6 + face]
+
+out vec3 vertexColor;
+
+// Corners of each face, same order and winding as the mesher's FACES table
+const vec3 CORNERS[24] = vec3[24](
+    vec3(-1, -1, -1), vec3(-1, -1,  1), vec3(-1,  1,  1), vec3(-1,  1, -1),
+    vec3( 1, -1,  1), vec3( 1, -1, -1), vec3( 1,  1, -1), vec3( 1,  1,  1),
+    vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1), vec3( 1,  1, -1),
+    vec3(-1, -1,  1), vec3( 1, -1,  1), vec3( 1,  1,  1), vec3(-1,  1,  1),
+    vec3(-1, -1,  1), vec3(-1, -1, -1), vec3( 1, -1, -1), vec3( 1, -1,  1),
+    vec3(-1,  1, -1), vec3( 1,  1, -1), vec3( 1,  1,  1), vec3(-1,  1,  1)
+);
+const float AO_CURVE[4] = float[4](0.5, 0.7, 0.85, 1.0);
+
+void main()
+{
+    uvec2 record = texelFetch(faces, gl_VertexID >> 2).xy;
+    int x = int(record.x & 15u);
+    int z = int((record.x >> 4) & 15u);
+    int y = int((record.x >> 8) & 255u);
+    int face = int((record.x >> 16) & 7u);
+    int type = int((record.x >> 19) & 255u);
+    bool flipped = ((record.x >> 27) & 1u) != 0u;
+
+    // Triangles are always 0,1,2 2,3,0 - a flipped face splits along the
+    // other diagonal, which is the same quad starting one corner later
+    int corner = ((gl_VertexID & 3) + (flipped ? 1 : 0)) & 3;
+    vec3 center = vec3(chunkOrigin.x + x, y, chunkOrigin.y + z);
+    gl_Position = projection * view * vec4(center + CORNERS[face * 4 + corner] * 0.5, 1.0);
+
+    // Same light and AO curves as the baked vertex colors
+    uint ao = (record.y >> (2 * corner)) & 3u;
+    uint light = (record.y >> 8) & 15u;
+    float brightness = max(pow(0.8, float(15u - light)), 0.05);
+    vertexColor = faceColors[type * 6 + face] * brightness * AO_CURVE[ao];
+}
+)";
+
+namespace {
+    constexpr GLuint CAMERA_BINDING = 0; // uniform buffer binding point of the Camera block
+
+    struct CameraBlock {
+        glm::mat4 projection;
+        glm::mat4 view;
+    };
+}
+
+Renderer::Renderer()
+    : VAO(0), VBO(0), EBO(0), shaderProgram(0), faceShaderProgram(0), cameraUBO(0),
+      cubeBufferBytes(0), modelIsIdentity(false) {}
 
 Renderer::~Renderer() {
-    if (VAO) glDeleteVertexArrays(1, &VAO);
-    if (VBO) glDeleteBuffers(1, &VBO);
-    if (EBO) glDeleteBuffers(1, &EBO);
-    if (shaderProgram) glDeleteProgram(shaderProgram);
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        MemoryTracker::add(MemoryCategory::GPU_BUFFERS, -cubeBufferBytes, -2);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, -1);
+    }
+    if (cameraUBO) {
+        glDeleteBuffers(1, &cameraUBO);
+        MemoryTracker::add(MemoryCategory::GPU_BUFFERS, -static_cast<int64_t>(sizeof(CameraBlock)), -1);
+    }
+    if (shaderProgram) {
+        glDeleteProgram(shaderProgram);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, -1);
+    }
+    if (faceShaderProgram) {
+        glDeleteProgram(faceShaderProgram);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, -1);
+    }
 }
 
-void Renderer::init(int width, int height) {
+void Renderer::init(int width, int height, GLADloadproc loader) {
     // Initialize GLAD to load modern OpenGL function pointers
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (!gladLoadGLLoader(loader)) {
         std::cerr << "Failed to initialize GLAD" << std::endl;
         return;
     }
@@ -56,16 +139,30 @@ void Renderer::init(int width, int height) {
     // Enable depth testing for 3D
     glEnable(GL_DEPTH_TEST);
 
+    // Camera uniform buffer, filled in by setViewMatrix/setProjectionMatrix
+    glGenBuffers(1, &cameraUBO);
+    state.bindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BINDING, cameraUBO);
+    MemoryTracker::add(MemoryCategory::GPU_BUFFERS, sizeof(CameraBlock), 1);
+
     // Create shader program
-    shaderProgram = createShaderProgram();
+    shaderProgram = createShaderProgram("#version 330 core\n" + std::string(cameraBlockSource) + vertexShaderSource);
+    createFaceShaderProgram();
 
     // Setup cube vertices
     setupCubeVertices();
 
     // Get uniform locations
-    viewLoc = glGetUniformLocation(shaderProgram, "view");
-    projLoc = glGetUniformLocation(shaderProgram, "projection");
     modelLoc = glGetUniformLocation(shaderProgram, "model");
+    setModelIdentity();
+}
+
+void Renderer::setModelIdentity() {
+    state.useProgram(shaderProgram);
+    glm::mat4 identity = glm::mat4(1.0f);
+    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &identity[0][0]);
+    modelIsIdentity = true;
 }
 
 void Renderer::setupCubeVertices() {
@@ -107,10 +204,13 @@ void Renderer::setupCubeVertices() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
+    cubeBufferBytes = sizeof(vertices) + sizeof(indices);
+    MemoryTracker::add(MemoryCategory::GPU_BUFFERS, cubeBufferBytes, 2);
+    MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, 1);
 
-    glBindVertexArray(VAO);
+    state.bindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    state.bindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
@@ -119,9 +219,6 @@ void Renderer::setupCubeVertices() {
     // Vertex attribute pointers
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
 }
 
 GLuint Renderer::compileShader(const std::string& source, GLenum shaderType) {
@@ -142,11 +239,12 @@ GLuint Renderer::compileShader(const std::string& source, GLenum shaderType) {
     return shader;
 }
 
-GLuint Renderer::createShaderProgram() {
-    GLuint vertexShader = compileShader(vertexShaderSource, GL_VERTEX_SHADER);
+GLuint Renderer::createShaderProgram(const std::string& vertexSource) {
+    GLuint vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
     GLuint fragmentShader = compileShader(fragmentShaderSource, GL_FRAGMENT_SHADER);
 
     GLuint program = glCreateProgram();
+    MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, 1);
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
     glLinkProgram(program);
@@ -163,29 +261,65 @@ GLuint Renderer::createShaderProgram() {
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
+    GLuint cameraBlock = glGetUniformBlockIndex(program, "Camera");
+    if (cameraBlock != GL_INVALID_INDEX) glUniformBlockBinding(program, cameraBlock, CAMERA_BINDING);
+
     return program;
 }
 
+void Renderer::createFaceShaderProgram() {
+    std::string source = "#version 330 core\n#define FACE_COLOR_COUNT " +
+                         std::to_string(BlockRegistry::COUNT * FACE_COUNT) + "\n" +
+                         cameraBlockSource + faceVertexShaderSource;
+    faceShaderProgram = createShaderProgram(source);
+    chunkOriginLoc = glGetUniformLocation(faceShaderProgram, "chunkOrigin");
+
+    // Block colors never change, upload them once
+    std::vector<float> colors;
+    for (std::size_t type = 0; type < BlockRegistry::COUNT; ++type) {
+        for (int face = 0; face < FACE_COUNT; ++face) {
+            const BlockColor& c = BlockRegistry::faceColor(static_cast<BlockType>(type), face);
+            colors.insert(colors.end(), { c.r, c.g, c.b });
+        }
+    }
+    state.useProgram(faceShaderProgram);
+    glUniform3fv(glGetUniformLocation(faceShaderProgram, "faceColors"),
+                 static_cast<GLsizei>(colors.size() / 3), colors.data());
+    glUniform1i(glGetUniformLocation(faceShaderProgram, "faces"), 0); // texture unit 0
+}
+
 void Renderer::clear() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void Renderer::drawCube(glm::vec3 position) {
-    glUseProgram(shaderProgram);
+    state.useProgram(shaderProgram);
 
     glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
+    modelIsIdentity = false;
 
-    glBindVertexArray(VAO);
+    state.bindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
 }
 
+void Renderer::useChunkProgram(MeshFormat format) {
+    if (format == MeshFormat::FACES) {
+        state.useProgram(faceShaderProgram);
+        return;
+    }
+    // Chunk vertices are already in world space
+    if (!modelIsIdentity) setModelIdentity();
+    state.useProgram(shaderProgram);
+}
+
 void Renderer::setViewMatrix(glm::mat4 view) {
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view[0][0]);
+    // Both programs read the camera block, no program switches needed
+    state.bindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(CameraBlock, view), sizeof(glm::mat4), &view[0][0]);
 }
 
 void Renderer::setProjectionMatrix(glm::mat4 projection) {
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, &projection[0][0]);
+    state.bindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(CameraBlock, projection), sizeof(glm::mat4), &projection[0][0]);
 }
@@ -0,0 +1,105 @@
+#include "core/Replay.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool CameraPath::save(const std::string& path) const {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "Can't write camera path " << path << std::endl;
+        return false;
+    }
+    std::fprintf(file, "seed %d\ndistance %d\n", seed, renderDistance);
+    for (const RecordedFrame& f : frames) {
+        std::fprintf(file, "frame %.9g %.9g %.9g %.9g %.9g\n",
+                     f.position.x, f.position.y, f.position.z, f.yaw, f.pitch);
+        for (const RecordedEdit& e : f.edits) {
+            std::fprintf(file, "edit %d %d %d %d\n", e.x, e.y, e.z, static_cast<int>(e.type));
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+bool CameraPath::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Can't read camera path " << path << std::endl;
+        return false;
+    }
+
+    frames.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream in(line);
+        std::string kind;
+        if (!(in >> kind)) continue; // blank line
+
+        bool ok = true;
+        if (kind == "seed") {
+            ok = static_cast<bool>(in >> seed);
+        } else if (kind == "distance") {
+            ok = static_cast<bool>(in >> renderDistance);
+        } else if (kind == "frame") {
+            RecordedFrame f;
+            ok = static_cast<bool>(in >> f.position.x >> f.position.y >> f.position.z >> f.yaw >> f.pitch);
+            if (ok) frames.push_back(std::move(f));
+        } else if (kind == "edit") {
+            RecordedEdit e;
+            int type = 0;
+            ok = static_cast<bool>(in >> e.x >> e.y >> e.z >> type) && !frames.empty() &&
+                 type >= 0 && type < static_cast<int>(BlockType::COUNT);
+            e.type = static_cast<BlockType>(type);
+            if (ok) frames.back().edits.push_back(e);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << path << ":" << lineNumber << ": bad line: " << line << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReplayReport::beginFrame(const World& world) {
+    m_before = world.getStats();
+    if (!m_started) {
+        m_first = m_before;
+        m_started = true;
+    }
+    m_frameStart = std::chrono::steady_clock::now();
+}
+
+void ReplayReport::endFrame(const World& world) {
+    auto elapsed = std::chrono::steady_clock::now() - m_frameStart;
+    m_frameMs.add(std::chrono::duration<double, std::milli>(elapsed).count());
+
+    m_last = world.getStats();
+    m_meshMs.add(m_last.meshMs - m_before.meshMs);
+    m_chunksLoaded.add(static_cast<double>(m_last.chunksLoaded - m_before.chunksLoaded));
+}
+
+void ReplayReport::print(std::ostream& out) const {
+    out << m_frameMs.count() << " frames\n";
+    out << "  frame ms: mean " << m_frameMs.mean()
+        << "  p50 " << m_frameMs.percentile(50.0)
+        << "  p95 " << m_frameMs.percentile(95.0)
+        << "  p99 " << m_frameMs.percentile(99.0)
+        << "  max " << m_frameMs.max() << "\n";
+    out << "  mesh ms/frame: mean " << m_meshMs.mean()
+        << "  p99 " << m_meshMs.percentile(99.0)
+        << "  max " << m_meshMs.max() << "\n";
+    out << "  chunks loaded/frame: mean " << m_chunksLoaded.mean()
+        << "  max " << m_chunksLoaded.max() << "\n";
+    out << "  totals: " << m_last.chunksLoaded - m_first.chunksLoaded << " chunks loaded, "
+        << m_last.chunksUnloaded - m_first.chunksUnloaded << " unloaded, "
+        << m_last.meshesBuilt - m_first.meshesBuilt << " meshes built\n";
+    out << "  totals ms: generate " << m_last.generateMs - m_first.generateMs
+        << ", light " << m_last.lightMs - m_first.lightMs
+        << ", mesh " << m_last.meshMs - m_first.meshMs << "\n";
+}
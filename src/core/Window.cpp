@@ -1,8 +1,8 @@
 #include "core/Window.hpp"
 #include <iostream>
 
-Window::Window(int width, int height, const std::string& title)
-    : m_window(nullptr), m_width(width), m_height(height), m_title(title) {
+Window::Window(int width, int height, const std::string& title, WindowMode mode)
+    : m_window(nullptr), m_width(width), m_height(height), m_title(title), m_mode(mode) {
     m_firstMouse = true;
     m_lastMouseX = width / 2.0;
     m_lastMouseY = height / 2.0;
@@ -31,6 +31,10 @@ void Window::init() {
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
+    if (m_mode == WindowMode::HIDDEN) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
+
     // Create a windowed mode window and its OpenGL context
     m_window = glfwCreateWindow(m_width, m_height, m_title.c_str(), nullptr, nullptr);
     if (!m_window) {
@@ -76,6 +80,11 @@ bool Window::isKeyDown(int key) const {
     return glfwGetKey(m_window, key) == GLFW_PRESS || glfwGetKey(m_window, key) == GLFW_REPEAT;
 }
 
+bool Window::isMouseButtonDown(int button) const {
+    if (!m_window) return false;
+    return glfwGetMouseButton(m_window, button) == GLFW_PRESS;
+}
+
 void Window::enableRawMouse(bool enabled) {
     if (!m_window) return;
     glfwSetInputMode(m_window, GLFW_CURSOR, enabled ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
@@ -0,0 +1,331 @@
+#include "core/WorldRenderer.hpp"
+#include "core/MemoryTracker.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+WorldRenderer::~WorldRenderer() {
+    for (auto& [key, mesh] : m_meshes) release(mesh);
+    for (auto& node : m_freeMeshes) release(node.mapped());
+    if (m_faceVAO) {
+        glDeleteVertexArrays(1, &m_faceVAO);
+        glDeleteBuffers(1, &m_quadEBO);
+        MemoryTracker::add(MemoryCategory::GPU_BUFFERS, -m_quadBytes, -1);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, -1);
+    }
+    MemoryTracker::add(MemoryCategory::MESH_CPU, -static_cast<int64_t>(m_scratchBytes));
+}
+
+void WorldRenderer::render(World& world, Renderer& renderer, const glm::vec3& cameraPos) {
+    uploadMeshes(world, renderer, cameraPos);
+    draw(renderer, cameraPos);
+}
+
+void WorldRenderer::uploadMeshes(World& world, Renderer& renderer, const glm::vec3& cameraPos) {
+    ++m_frame;
+    GLStateCache& state = renderer.getState();
+    state.setStats(&m_stats);
+
+    m_newChunks.clear();
+    world.forEachChunk([&](Chunk& chunk) {
+        auto it = m_meshes.find(chunkKey(chunk.getChunkX(), chunk.getChunkZ()));
+        if (it != m_meshes.end()) {
+            it->second.lastSeen = m_frame;
+        } else {
+            m_newChunks.push_back(&chunk);
+        }
+    });
+
+    // Anything we didn't see this frame was unloaded. Retire those before
+    // adding the new chunks, so the new ones take over their GL objects
+    for (auto it = m_meshes.begin(); it != m_meshes.end();) {
+        if (it->second.lastSeen != m_frame) {
+            it = retire(it);
+        } else {
+            ++it;
+        }
+    }
+    for (Chunk* chunk : m_newChunks) addMesh(chunk->getChunkX(), chunk->getChunkZ());
+    trimFreeMeshes();
+    forgetReleased(state);
+
+    m_uploadQueue.clear();
+    world.forEachChunk([&](Chunk& chunk) {
+        if (chunk.hasPendingMesh()) m_uploadQueue.push_back(&chunk);
+    });
+
+    // Over the limit: chunks with nothing on screen yet first, then the
+    // nearest. The rest keep their pending mesh for the next frame
+    m_pendingUploads = 0;
+    if (m_uploadLimit > 0 && m_uploadQueue.size() > m_uploadLimit) {
+        int cameraX = static_cast<int>(std::floor(cameraPos.x / Chunk::WIDTH));
+        int cameraZ = static_cast<int>(std::floor(cameraPos.z / Chunk::DEPTH));
+        auto priority = [&](const Chunk* chunk) {
+            const ChunkMesh& mesh = m_meshes.find(chunkKey(chunk->getChunkX(), chunk->getChunkZ()))->second;
+            int64_t dx = chunk->getChunkX() - cameraX;
+            int64_t dz = chunk->getChunkZ() - cameraZ;
+            uint64_t distance = static_cast<uint64_t>(std::min<int64_t>(dx * dx + dz * dz, UINT32_MAX));
+            return static_cast<uint64_t>(mesh.count > 0) << 32 | distance;
+        };
+        std::partial_sort(m_uploadQueue.begin(), m_uploadQueue.begin() + m_uploadLimit, m_uploadQueue.end(),
+                          [&](const Chunk* a, const Chunk* b) { return priority(a) < priority(b); });
+        m_pendingUploads = m_uploadQueue.size() - m_uploadLimit;
+        m_uploadQueue.resize(m_uploadLimit);
+    }
+
+    for (Chunk* chunk : m_uploadQueue) {
+        ChunkMesh& mesh = m_meshes.find(chunkKey(chunk->getChunkX(), chunk->getChunkZ()))->second;
+        chunk->takePendingMesh(m_scratch);
+        upload(state, mesh, m_scratch);
+        forgetReleased(state);
+    }
+    m_stats.uploadsDeferred += m_pendingUploads;
+
+    // Taking meshes swaps buffers with the chunks, so the scratch size drifts
+    std::size_t scratchBytes = m_scratch.capacityBytes();
+    MemoryTracker::add(MemoryCategory::MESH_CPU, static_cast<int64_t>(scratchBytes) - static_cast<int64_t>(m_scratchBytes));
+    m_scratchBytes = scratchBytes;
+    state.setStats(nullptr);
+}
+
+void WorldRenderer::forgetReleased(GLStateCache& state) {
+    // Deleted names may be bound, and glGen* hands them out again
+    if (m_released) {
+        state.invalidate();
+        m_released = false;
+    }
+}
+
+WorldRenderer::MeshMap::iterator WorldRenderer::retire(MeshMap::iterator it) {
+    auto next = std::next(it);
+    MeshMap::node_type node = m_meshes.extract(it);
+    node.mapped().count = 0; // keeps its GL objects, but nothing to draw
+    m_freeMeshes.push_back(std::move(node));
+    return next;
+}
+
+void WorldRenderer::addMesh(int chunkX, int chunkZ) {
+    int64_t key = chunkKey(chunkX, chunkZ);
+    ChunkMesh* mesh;
+    if (m_freeMeshes.empty()) {
+        mesh = &m_meshes[key];
+    } else {
+        MeshMap::node_type node = std::move(m_freeMeshes.back());
+        m_freeMeshes.pop_back();
+        node.key() = key;
+        mesh = &m_meshes.insert(std::move(node)).position->second;
+    }
+    mesh->chunkX = chunkX;
+    mesh->chunkZ = chunkZ;
+    mesh->lastSeen = m_frame;
+}
+
+void WorldRenderer::trimFreeMeshes() {
+    // Enough for the chunks streamed in while moving, the rest only piles up
+    // when the world shrinks (lower render distance) and can go
+    std::size_t keep = m_meshes.size() / 4 + MIN_FREE_MESHES;
+    while (m_freeMeshes.size() > keep) {
+        release(m_freeMeshes.back().mapped());
+        m_freeMeshes.pop_back();
+    }
+}
+
+void WorldRenderer::draw(Renderer& renderer, const glm::vec3& cameraPos) {
+    GLStateCache& state = renderer.getState();
+    state.setStats(&m_stats);
+
+    // Program first so each one is bound once (both formats are only around
+    // for a few frames after the format changed), then nearest first
+    int cameraX = static_cast<int>(std::floor(cameraPos.x / Chunk::WIDTH));
+    int cameraZ = static_cast<int>(std::floor(cameraPos.z / Chunk::DEPTH));
+    m_drawList.clear();
+    for (const auto& [key, mesh] : m_meshes) {
+        if (mesh.count == 0) continue;
+        int64_t dx = mesh.chunkX - cameraX;
+        int64_t dz = mesh.chunkZ - cameraZ;
+        uint64_t distance = static_cast<uint64_t>(std::min<int64_t>(dx * dx + dz * dz, UINT32_MAX));
+        m_drawList.push_back({ static_cast<uint64_t>(mesh.format) << 32 | distance, &mesh });
+    }
+    std::sort(m_drawList.begin(), m_drawList.end(),
+              [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+
+    bool first = true;
+    MeshFormat format = MeshFormat::VERTICES;
+    for (const DrawItem& item : m_drawList) {
+        const ChunkMesh& mesh = *item.mesh;
+        if (first || mesh.format != format) {
+            first = false;
+            format = mesh.format;
+            renderer.useChunkProgram(format);
+            // Every FACES chunk draws from the same VAO
+            if (format == MeshFormat::FACES) state.bindVertexArray(m_faceVAO);
+        }
+        if (format == MeshFormat::FACES) {
+            drawFaces(state, renderer.getChunkOriginLocation(), mesh);
+        } else {
+            drawVertices(state, mesh);
+        }
+    }
+    state.setStats(nullptr);
+}
+
+void WorldRenderer::drawVertices(GLStateCache& state, const ChunkMesh& mesh) {
+    state.bindVertexArray(mesh.VAO);
+    glDrawElements(GL_TRIANGLES, mesh.count, GL_UNSIGNED_INT, 0);
+    ++m_stats.drawCalls;
+    m_stats.triangles += mesh.count / 3;
+}
+
+void WorldRenderer::drawFaces(GLStateCache& state, GLint originLoc, const ChunkMesh& mesh) {
+    // The shader turns the index (gl_VertexID) into face + corner. Indexed
+    // rather than 6 plain vertices per face so the 2 shared corners come out
+    // of the post-transform cache instead of running the shader again
+    state.bindBufferTexture(mesh.texture);
+    glUniform2i(originLoc, mesh.chunkX * Chunk::WIDTH, mesh.chunkZ * Chunk::DEPTH);
+    glDrawElements(GL_TRIANGLES, mesh.count * 6, GL_UNSIGNED_INT, 0);
+    ++m_stats.stateChanges;
+    ++m_stats.drawCalls;
+    m_stats.triangles += static_cast<uint64_t>(mesh.count) * 2;
+}
+
+void WorldRenderer::reserveQuadIndices(GLStateCache& state, GLsizei faceCount) {
+    if (faceCount <= m_quadCapacity) return;
+    // Grow in big steps, remeshes shouldn't rebuild this every time a chunk gains a face
+    m_quadCapacity = std::max(faceCount, std::max<GLsizei>(m_quadCapacity * 2, 16384));
+
+    std::vector<unsigned int> indices;
+    indices.reserve(static_cast<std::size_t>(m_quadCapacity) * 6);
+    for (unsigned int base = 0; base < static_cast<unsigned int>(m_quadCapacity) * 4; base += 4) {
+        unsigned int quad[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+        indices.insert(indices.end(), quad, quad + 6);
+    }
+
+    if (!m_faceVAO) {
+        glGenVertexArrays(1, &m_faceVAO);
+        glGenBuffers(1, &m_quadEBO);
+        MemoryTracker::add(MemoryCategory::GPU_BUFFERS, 0, 1);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, 1);
+    }
+    state.bindVertexArray(m_faceVAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    int64_t bytes = static_cast<int64_t>(indices.size() * sizeof(unsigned int));
+    MemoryTracker::add(MemoryCategory::GPU_BUFFERS, bytes - m_quadBytes);
+    m_quadBytes = bytes;
+    ++m_stats.stateChanges;
+    ++m_stats.uploads;
+    m_stats.uploadBytes += indices.size() * sizeof(unsigned int);
+}
+
+void WorldRenderer::upload(GLStateCache& state, ChunkMesh& mesh, const ChunkMeshData& data) {
+    // Buffers of the other format are no use, start over
+    if (mesh.format != data.format) {
+        release(mesh);
+        mesh.format = data.format;
+        forgetReleased(state);
+    }
+    if (data.format == MeshFormat::FACES) {
+        uploadFaces(state, mesh, data);
+        return;
+    }
+
+    mesh.count = static_cast<GLsizei>(data.indices.size());
+
+    // If no visible blocks, skip GPU upload
+    if (mesh.count == 0) {
+        release(mesh);
+        return;
+    }
+
+    if (!mesh.VAO) {
+        glGenVertexArrays(1, &mesh.VAO);
+        glGenBuffers(1, &mesh.VBO);
+        glGenBuffers(1, &mesh.EBO);
+        MemoryTracker::add(MemoryCategory::GPU_BUFFERS, 0, 2);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, 1);
+
+        state.bindVertexArray(mesh.VAO);
+        state.bindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+
+        // Vertex position attribute (location 0): 3 floats, offset 0
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        // Vertex color attribute (location 1): 3 floats, offset 3*sizeof(float)
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        ++m_stats.stateChanges;
+    } else {
+        // The element buffer is VAO state, binding the VAO brings it along
+        state.bindVertexArray(mesh.VAO);
+        state.bindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    }
+
+    // Remeshes reuse the same buffers, glBufferData just resizes them
+    glBufferData(GL_ARRAY_BUFFER, data.vertices.size() * sizeof(float), data.vertices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(unsigned int), data.indices.data(), GL_STATIC_DRAW);
+    std::size_t bytes = data.vertices.size() * sizeof(float) + data.indices.size() * sizeof(unsigned int);
+    trackBufferBytes(mesh, static_cast<int64_t>(bytes));
+    m_stats.uploads += 2;
+    m_stats.uploadBytes += bytes;
+}
+
+void WorldRenderer::uploadFaces(GLStateCache& state, ChunkMesh& mesh, const ChunkMeshData& data) {
+    mesh.count = static_cast<GLsizei>(data.faceCount());
+    if (mesh.count == 0) {
+        release(mesh);
+        return;
+    }
+
+    // GL 3.3 only promises 65536 texels per buffer texture. Desktop drivers
+    // (llvmpipe included) allow millions, a chunk rarely has more than 10k faces
+    if (!m_maxBufferTexels) glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &m_maxBufferTexels);
+    if (mesh.count > m_maxBufferTexels) {
+        std::cerr << "Chunk " << mesh.chunkX << "," << mesh.chunkZ << " has " << mesh.count
+                  << " faces, only " << m_maxBufferTexels << " fit in a buffer texture" << std::endl;
+        mesh.count = m_maxBufferTexels;
+    }
+
+    reserveQuadIndices(state, mesh.count);
+
+    if (!mesh.VBO) {
+        glGenBuffers(1, &mesh.VBO);
+        glGenTextures(1, &mesh.texture);
+        MemoryTracker::add(MemoryCategory::GPU_BUFFERS, 0, 1);
+        MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, 1);
+    }
+
+    // 2 x 32 bits per face = one RG32UI texel
+    state.bindBuffer(GL_TEXTURE_BUFFER, mesh.VBO);
+    glBufferData(GL_TEXTURE_BUFFER, data.faces.size() * sizeof(uint32_t), data.faces.data(), GL_STATIC_DRAW);
+    state.bindBufferTexture(mesh.texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, mesh.VBO);
+    trackBufferBytes(mesh, static_cast<int64_t>(data.faces.size() * sizeof(uint32_t)));
+    ++m_stats.uploads;
+    m_stats.uploadBytes += data.faces.size() * sizeof(uint32_t);
+}
+
+void WorldRenderer::release(ChunkMesh& mesh) {
+    int64_t buffers = (mesh.VBO ? 1 : 0) + (mesh.EBO ? 1 : 0);
+    int64_t others = (mesh.VAO ? 1 : 0) + (mesh.texture ? 1 : 0);
+    MemoryTracker::add(MemoryCategory::GPU_BUFFERS, -mesh.gpuBytes, -buffers);
+    MemoryTracker::add(MemoryCategory::GL_OBJECTS, 0, -others);
+
+    if (mesh.VAO) glDeleteVertexArrays(1, &mesh.VAO);
+    if (mesh.VBO) glDeleteBuffers(1, &mesh.VBO);
+    if (mesh.EBO) glDeleteBuffers(1, &mesh.EBO);
+    if (mesh.texture) glDeleteTextures(1, &mesh.texture);
+    if (mesh.VAO || mesh.VBO || mesh.texture) m_released = true;
+    mesh.VAO = mesh.VBO = mesh.EBO = mesh.texture = 0;
+    mesh.count = 0;
+    mesh.gpuBytes = 0;
+}
+
+void WorldRenderer::trackBufferBytes(ChunkMesh& mesh, int64_t bytes) {
+    MemoryTracker::add(MemoryCategory::GPU_BUFFERS, bytes - mesh.gpuBytes);
+    mesh.gpuBytes = bytes;
+}
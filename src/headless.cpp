@@ -0,0 +1,229 @@
+// Headless dedicated simulation - no window, no GL context
+// Runs a Simulation with a crowd of bot players (and optionally fast flying
+// viewers to stress chunk streaming) at the fixed tick rate, then prints
+// tick-time percentiles. Used for server load tests on machines without a GPU.
+//
+// usage: minecraft_headless [--players N] [--viewers N] [--seconds S]
+//                           [--distance D] [--spread BLOCKS] [--fly-speed BLOCKS_PER_S]
+//                           [--seed SEED] [--realtime] [--memory-log FILE]
+//        minecraft_headless --replay FILE
+//
+// --memory-log writes memory use to FILE every second (CSV, "-" for stdout)
+//
+// --replay runs the CPU side of a recorded camera path (see core/Replay.hpp):
+// chunk streaming and meshing, everything but the GL upload and draw. It also
+// counts heap allocations per frame, which should stay at 0 once the chunk
+// pool has grown to cover the view distance
+
+#include "core/MemoryTracker.hpp"
+#include "core/Replay.hpp"
+#include "core/Stats.hpp"
+#include "world/Simulation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Every heap allocation in the process goes through here, for --replay
+static std::atomic<uint64_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct Options {
+    int players = 100;
+    int viewers = 0;
+    float seconds = 30.0f;
+    int distance = 4;
+    int spread = 256;        // players spawn in a square this many blocks across
+    float flySpeed = 20.0f;  // viewers fly in a straight line at this speed
+    int seed = 42;
+    bool realtime = false;   // sleep between ticks like a real server would
+    std::string replay;      // camera path to replay instead of simulating players
+    std::string memoryLog;
+};
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!std::strcmp(arg, "--realtime")) { opt.realtime = true; continue; }
+        if (!value) return false;
+        if (!std::strcmp(arg, "--players")) opt.players = std::atoi(value);
+        else if (!std::strcmp(arg, "--viewers")) opt.viewers = std::atoi(value);
+        else if (!std::strcmp(arg, "--seconds")) opt.seconds = static_cast<float>(std::atof(value));
+        else if (!std::strcmp(arg, "--distance")) opt.distance = std::atoi(value);
+        else if (!std::strcmp(arg, "--spread")) opt.spread = std::atoi(value);
+        else if (!std::strcmp(arg, "--fly-speed")) opt.flySpeed = static_cast<float>(std::atof(value));
+        else if (!std::strcmp(arg, "--seed")) opt.seed = std::atoi(value);
+        else if (!std::strcmp(arg, "--replay")) opt.replay = value;
+        else if (!std::strcmp(arg, "--memory-log")) opt.memoryLog = value;
+        else return false;
+        ++i;
+    }
+    return true;
+}
+
+// Wanders around: walks forward, turns now and then, jumps when it bumps into something
+struct Bot {
+    std::mt19937 rng;
+    PlayerInput input;
+    int ticksUntilTurn = 0;
+
+    explicit Bot(uint32_t seed) : rng(seed) {
+        input.forward = 1.0f;
+        input.yaw = std::uniform_real_distribution<float>(-180.0f, 180.0f)(rng);
+    }
+
+    const PlayerInput& think(const Player& player) {
+        if (--ticksUntilTurn <= 0) {
+            input.yaw += std::uniform_real_distribution<float>(-90.0f, 90.0f)(rng);
+            ticksUntilTurn = std::uniform_int_distribution<int>(2, 6)(rng) * Simulation::TICK_RATE;
+        }
+        glm::vec3 v = player.getVelocity();
+        input.jump = player.isOnGround() && v.x * v.x + v.z * v.z < 0.5f;
+        return input;
+    }
+};
+
+int replay(const std::string& file) {
+    CameraPath path;
+    if (!path.load(file)) return 1;
+
+    // Meshes get built like in the game, they just never go to a GPU
+    World world(path.seed, WorldMode::LOCAL);
+    ReplayReport report;
+    SampleStats allocations;
+    // A renderer would take the meshes every frame, so the chunks' buffers go round
+    ChunkMeshData taken;
+    for (const RecordedFrame& frame : path.frames) {
+        report.beginFrame(world);
+        uint64_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+        for (const RecordedEdit& e : frame.edits) world.setBlock(e.x, e.y, e.z, e.type);
+        world.tick(); // a replay frame is one tick long
+        world.update(frame.position, path.renderDistance);
+        world.forEachChunk([&](Chunk& chunk) { chunk.takePendingMesh(taken); });
+        uint64_t frameAllocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        report.endFrame(world);
+        allocations.add(static_cast<double>(frameAllocations));
+    }
+
+    std::cout << "replay " << file << " (seed " << path.seed << ", distance " << path.renderDistance
+              << ", " << REPLAY_DT * 1000.0f << " ms steps), CPU only\n";
+    report.print(std::cout);
+    std::cout << "  heap allocations/frame: mean " << allocations.mean()
+              << "  p50 " << allocations.percentile(50.0)
+              << "  p99 " << allocations.percentile(99.0)
+              << "  max " << allocations.max()
+              << "  (frames with any: " << allocations.countAbove(0.0) << ")\n";
+    std::cout << "  chunk pool: " << world.getChunkPool().getCapacity() << " chunks in "
+              << world.getChunkPool().getSlabCount() << " slabs\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        std::cerr << "usage: minecraft_headless [--players N] [--viewers N] [--seconds S] [--distance D]\n"
+                     "                          [--spread BLOCKS] [--fly-speed BLOCKS_PER_S] [--seed SEED] [--realtime]\n"
+                     "                          [--memory-log FILE]\n"
+                     "       minecraft_headless --replay FILE\n";
+        return 1;
+    }
+    if (!opt.replay.empty()) return replay(opt.replay);
+
+    MemoryLog memoryLog;
+    if (!opt.memoryLog.empty() && !memoryLog.open(opt.memoryLog, 1.0)) return 1;
+
+    using clock = std::chrono::steady_clock;
+    auto startup = clock::now();
+
+    Simulation sim(opt.seed, opt.distance);
+    std::mt19937 rng(static_cast<uint32_t>(opt.seed));
+    std::uniform_int_distribution<int> spawn(-opt.spread / 2, opt.spread / 2);
+
+    std::vector<Bot> bots;
+    for (int i = 0; i < opt.players; ++i) {
+        sim.addPlayer(spawn(rng), spawn(rng));
+        bots.emplace_back(rng());
+    }
+
+    std::vector<glm::vec3> flyDirs;
+    for (int i = 0; i < opt.viewers; ++i) {
+        float angle = std::uniform_real_distribution<float>(0.0f, 6.2831853f)(rng);
+        sim.addViewer(glm::vec3(spawn(rng), 100.0f, spawn(rng)));
+        flyDirs.emplace_back(std::cos(angle), 0.0f, std::sin(angle));
+    }
+
+    double startupMs = std::chrono::duration<double, std::milli>(clock::now() - startup).count();
+    std::cout << "spawned " << opt.players << " players, " << opt.viewers << " viewers in "
+              << startupMs << " ms (" << sim.getWorld().getChunkCount() << " chunks)\n";
+
+    const int ticks = static_cast<int>(opt.seconds * Simulation::TICK_RATE);
+    const double budgetMs = 1000.0 / Simulation::TICK_RATE;
+    const auto tickLength = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(Simulation::TICK_DT));
+
+    SampleStats tickMs;
+    std::size_t peakChunks = 0;
+    auto runStart = clock::now();
+    auto nextTick = runStart;
+
+    for (int t = 0; t < ticks; ++t) {
+        auto tickStart = clock::now();
+
+        for (std::size_t i = 0; i < bots.size(); ++i) {
+            sim.setInput(i, bots[i].think(sim.getPlayer(i)));
+        }
+        for (std::size_t i = 0; i < flyDirs.size(); ++i) {
+            sim.setViewerPosition(i, sim.getViewerPosition(i) + flyDirs[i] * (opt.flySpeed * Simulation::TICK_DT));
+        }
+        sim.tick();
+
+        tickMs.add(std::chrono::duration<double, std::milli>(clock::now() - tickStart).count());
+        memoryLog.update();
+        peakChunks = std::max(peakChunks, sim.getWorld().getChunkCount());
+
+        if (opt.realtime) {
+            // Behind schedule: start the next tick right away rather than trying to catch up
+            nextTick = std::max(nextTick + tickLength, clock::now());
+            std::this_thread::sleep_until(nextTick);
+        }
+    }
+
+    double wallSeconds = std::chrono::duration<double>(clock::now() - runStart).count();
+    double simSeconds = ticks * static_cast<double>(Simulation::TICK_DT);
+
+    std::cout << ticks << " ticks at " << Simulation::TICK_RATE << " Hz, view distance " << opt.distance
+              << ", seed " << opt.seed << "\n";
+    std::cout << "  tick ms: mean " << tickMs.mean()
+              << "  p50 " << tickMs.percentile(50.0)
+              << "  p90 " << tickMs.percentile(90.0)
+              << "  p99 " << tickMs.percentile(99.0)
+              << "  p99.9 " << tickMs.percentile(99.9)
+              << "  max " << tickMs.max() << "\n";
+    std::cout << "  over the " << budgetMs << " ms budget: " << tickMs.countAbove(budgetMs) << " ticks\n";
+    std::cout << "  simulated " << simSeconds << " s in " << wallSeconds << " s ("
+              << simSeconds / wallSeconds << "x real time)\n";
+    std::cout << "  chunks loaded: " << sim.getWorld().getChunkCount() << " now, " << peakChunks << " peak\n";
+    std::cout << "memory\n";
+    MemoryTracker::snapshot().print(std::cout);
+    memoryLog.write();
+    return 0;
+}
@@ -1,19 +1,79 @@
 #include "core/Renderer.hpp"
 #include "core/Window.hpp"
 #include "core/Camera.hpp"
+#include "core/FrameBudget.hpp"
+#include "core/MemoryTracker.hpp"
+#include "core/Replay.hpp"
+#include "core/WorldRenderer.hpp"
 #include "world/World.hpp"
+#include "world/Player.hpp"
+#include "net/ChunkClient.hpp"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    // --connect HOST[:PORT] plays on a server (see minecraft_server) instead of a local world
+    // --record FILE saves the camera path (and block edits) to FILE on exit
+    // --replay FILE plays a recorded path at a fixed timestep, prints frame stats and quits
+    //   (for a software GL context run with LIBGL_ALWAYS_SOFTWARE=1)
+    // --memory-log FILE writes memory use to FILE every 10 seconds (CSV, "-" for stdout)
+    // --frame-budget MS frame time to hold, 16.6 by default (8.3 for 120 Hz). Render distance
+    //   and streaming per frame follow it (see FrameBudget), 0 keeps the distance at 4.
+    //   Off while recording or replaying
+    // --budget-log FILE writes every frame budget decision to FILE (CSV, "-" for stdout)
+    std::string server, recordFile, replayFile, memoryLogFile, budgetLogFile;
+    double frameBudgetMs = 16.6;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!std::strcmp(argv[i], "--connect")) server = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--record")) recordFile = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--replay")) replayFile = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--memory-log")) memoryLogFile = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--frame-budget")) frameBudgetMs = std::atof(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--budget-log")) budgetLogFile = argv[i + 1];
+    }
+
+    int seed = 42; // for terrain generation
+    int renderDistance = 4;
+    const int maxRenderDistance = 16;
+
+    CameraPath path;
+    std::size_t replayFrame = 0;
+    ReplayReport report;
+    if (!replayFile.empty()) {
+        if (!path.load(replayFile)) return 1;
+        seed = path.seed;
+        renderDistance = path.renderDistance;
+        server.clear(); // replays are always local
+    }
+    path.seed = seed;
+    path.renderDistance = renderDistance;
+
+    MemoryLog memoryLog;
+    if (!memoryLogFile.empty() && !memoryLog.open(memoryLogFile)) return 1;
+
+    // Replays keep their recorded distance so runs stay comparable. So does
+    // recording: the path only saves the starting distance, a replay of a
+    // session whose distance moved would stream a different world
+    bool adaptive = frameBudgetMs > 0.0 && replayFile.empty() && recordFile.empty();
+    FrameBudget budget(adaptive ? frameBudgetMs : 16.6, renderDistance, maxRenderDistance);
+    BudgetLog budgetLog;
+    if (!budgetLogFile.empty() && !budgetLog.open(budgetLogFile)) return 1;
 
-int main() {
     Window window(800, 600, "Minecraft.cpp");
     Renderer renderer;
 
     // Initialize renderer with window dimensions (must be after window/context creation)
-    renderer.init(800, 600);
+    renderer.init(800, 600, (GLADloadproc)glfwGetProcAddress);
+    WorldRenderer worldRenderer;
 
     // Sky blue background
     glClearColor(0.5f, 0.7f, 1.0f, 1.0f);
@@ -28,9 +88,45 @@ int main() {
     window.enableRawMouse(true);
 
     bool f11Pressed = false;
+    bool leftPressed = false;
+    bool rightPressed = false;
+    BlockType selectedBlock = BlockType::STONE;
 
     // World setup
-    World world(42); // Seed for terrain generation
+    std::unique_ptr<World> localWorld;
+    std::unique_ptr<ChunkClient> client;
+    if (server.empty()) {
+        localWorld = std::make_unique<World>(seed);
+    } else {
+        std::string host = server;
+        uint16_t port = Protocol::DEFAULT_PORT;
+        std::size_t colon = server.rfind(':');
+        if (colon != std::string::npos) {
+            host = server.substr(0, colon);
+            port = static_cast<uint16_t>(std::atoi(server.c_str() + colon + 1));
+        }
+        client = std::make_unique<ChunkClient>();
+        if (!client->connect(host, port, 6)) return 1;
+    }
+    World& world = client ? client->getWorld() : *localWorld;
+    bool spawned = !client; // network games start at the server's spawn point
+    if (adaptive) {
+        world.setLoadLimit(budget.getLoadLimit());
+        worldRenderer.setUploadLimit(budget.getUploadLimit());
+    }
+
+    // Walking player, simulated at Player::TICK_RATE regardless of frame rate
+    // F toggles between walking and free flight
+    Player player(camera.getPosition() - glm::vec3(0.0f, Player::EYE_HEIGHT, 0.0f));
+    bool walking = false;
+    bool fPressed = false;
+    bool f3Pressed = false;
+    bool f4Pressed = false;
+    float tickAccumulator = 0.0f;
+    float worldTickAccumulator = 0.0f;
+
+    // Replays shouldn't wait on vsync
+    if (!replayFile.empty()) glfwSwapInterval(0);
 
     // Timing
     using clock = std::chrono::high_resolution_clock;
@@ -40,6 +136,7 @@ int main() {
     while (window.isOpen()) {
         // Poll events FIRST so input is fresh
         window.update();
+        memoryLog.update();
 
         // Time
         auto now = clock::now();
@@ -51,6 +148,31 @@ int main() {
             window.close();
         }
 
+        // Replay: the recorded camera and edits instead of input, one frame per REPLAY_DT
+        if (!replayFile.empty()) {
+            if (replayFrame == path.frames.size()) {
+                report.print(std::cout);
+                window.close();
+                continue;
+            }
+            const RecordedFrame& frame = path.frames[replayFrame++];
+            report.beginFrame(world);
+            camera.setPosition(frame.position);
+            camera.setOrientation(frame.yaw, frame.pitch);
+            for (const RecordedEdit& e : frame.edits) world.setBlock(e.x, e.y, e.z, e.type);
+            world.tick(); // a replay frame is one tick long
+            world.update(camera.getPosition(), renderDistance);
+
+            renderer.clear();
+            renderer.setViewMatrix(camera.getViewMatrix());
+            worldRenderer.render(world, renderer, camera.getPosition());
+            glFinish(); // count the GPU work in the frame time
+            report.endFrame(world);
+
+            window.swapBuffers();
+            continue;
+        }
+
         // F11: toggle fullscreen
         if (window.isKeyDown(GLFW_KEY_F11)) {
             if (!f11Pressed) {
@@ -68,13 +190,72 @@ int main() {
             f11Pressed = false;
         }
 
+        // F: toggle walking / flying
+        if (window.isKeyDown(GLFW_KEY_F)) {
+            if (!fPressed) {
+                fPressed = true;
+                walking = !walking;
+                if (walking) {
+                    player.setPosition(camera.getPosition() - glm::vec3(0.0f, Player::EYE_HEIGHT, 0.0f));
+                    tickAccumulator = 0.0f;
+                }
+            }
+        } else {
+            fPressed = false;
+        }
+
+        // F3: switch chunk meshes between full vertices and packed faces
+        if (window.isKeyDown(GLFW_KEY_F3)) {
+            if (!f3Pressed) {
+                f3Pressed = true;
+                bool faces = world.getMeshFormat() == MeshFormat::VERTICES;
+                world.setMeshFormat(faces ? MeshFormat::FACES : MeshFormat::VERTICES);
+                std::cout << "Mesh format: " << (faces ? "packed faces" : "vertices") << std::endl;
+            }
+        } else {
+            f3Pressed = false;
+        }
+
+        // F4: print memory use
+        if (window.isKeyDown(GLFW_KEY_F4)) {
+            if (!f4Pressed) {
+                f4Pressed = true;
+                std::cout << "Memory (" << world.getChunkCount() << " chunks loaded):\n";
+                MemoryTracker::snapshot().print(std::cout);
+            }
+        } else {
+            f4Pressed = false;
+        }
+
         // Movement
-        if (window.isKeyDown(GLFW_KEY_W)) camera.processKeyboard(Camera::FORWARD, deltaTime);
-        if (window.isKeyDown(GLFW_KEY_S)) camera.processKeyboard(Camera::BACKWARD, deltaTime);
-        if (window.isKeyDown(GLFW_KEY_A)) camera.processKeyboard(Camera::LEFT, deltaTime);
-        if (window.isKeyDown(GLFW_KEY_D)) camera.processKeyboard(Camera::RIGHT, deltaTime);
-        if (window.isKeyDown(GLFW_KEY_SPACE)) camera.processKeyboard(Camera::UP, deltaTime);
-        if (window.isKeyDown(GLFW_KEY_LEFT_SHIFT)) camera.processKeyboard(Camera::DOWN, deltaTime);
+        if (walking) {
+            PlayerInput input;
+            if (window.isKeyDown(GLFW_KEY_W)) input.forward += 1.0f;
+            if (window.isKeyDown(GLFW_KEY_S)) input.forward -= 1.0f;
+            if (window.isKeyDown(GLFW_KEY_D)) input.strafe += 1.0f;
+            if (window.isKeyDown(GLFW_KEY_A)) input.strafe -= 1.0f;
+            input.jump = window.isKeyDown(GLFW_KEY_SPACE);
+            input.yaw = camera.getYaw();
+
+            // Fixed-rate physics, capped so a long hitch doesn't spiral
+            tickAccumulator = std::min(tickAccumulator + deltaTime, 0.25f);
+            while (tickAccumulator >= Player::TICK_DT) {
+                player.tick(world, input);
+                tickAccumulator -= Player::TICK_DT;
+            }
+
+            // Interpolate between the last two ticks for smooth motion
+            float alpha = tickAccumulator / Player::TICK_DT;
+            glm::vec3 feet = glm::mix(player.getPreviousPosition(), player.getPosition(), alpha);
+            camera.setPosition(feet + glm::vec3(0.0f, Player::EYE_HEIGHT, 0.0f));
+        } else {
+            if (window.isKeyDown(GLFW_KEY_W)) camera.processKeyboard(Camera::FORWARD, deltaTime);
+            if (window.isKeyDown(GLFW_KEY_S)) camera.processKeyboard(Camera::BACKWARD, deltaTime);
+            if (window.isKeyDown(GLFW_KEY_A)) camera.processKeyboard(Camera::LEFT, deltaTime);
+            if (window.isKeyDown(GLFW_KEY_D)) camera.processKeyboard(Camera::RIGHT, deltaTime);
+            if (window.isKeyDown(GLFW_KEY_SPACE)) camera.processKeyboard(Camera::UP, deltaTime);
+            if (window.isKeyDown(GLFW_KEY_LEFT_SHIFT)) camera.processKeyboard(Camera::DOWN, deltaTime);
+        }
 
         // Arrow keys for looking (fallback if mouse capture doesn't work)
         float lookSpeed = 100.0f * deltaTime;
@@ -89,16 +270,90 @@ int main() {
             camera.processMouse(static_cast<float>(dx), static_cast<float>(dy));
         }
 
+        // Number keys pick the block to place (1 = STONE, 2 = DIRT, ...)
+        // Flowing water only comes from the simulation
+        for (int i = 1; i < static_cast<int>(BlockType::FLOWING_WATER_1); ++i) {
+            if (window.isKeyDown(GLFW_KEY_0 + i)) selectedBlock = static_cast<BlockType>(i);
+        }
+
+        // Left click breaks the block we're looking at, right click places against it
+        std::vector<RecordedEdit> frameEdits;
+        bool leftDown = window.isMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT);
+        bool rightDown = window.isMouseButtonDown(GLFW_MOUSE_BUTTON_RIGHT);
+        if ((leftDown && !leftPressed) || (rightDown && !rightPressed)) {
+            RaycastHit hit = world.raycast(camera.getPosition(), camera.getFront(), 8.0f);
+            if (hit.hit) {
+                bool breaking = leftDown && !leftPressed;
+                if (breaking || hit.face != BlockFace::NONE) {
+                    glm::ivec3 p = breaking ? hit.block : hit.adjacent();
+                    BlockType type = breaking ? BlockType::AIR : selectedBlock;
+                    // On a server the edit shows up once it comes back as a block delta
+                    if (client) client->requestBlockEdit(p.x, p.y, p.z, type);
+                    else world.setBlock(p.x, p.y, p.z, type);
+                    frameEdits.push_back({ p.x, p.y, p.z, type });
+                }
+            }
+        }
+        leftPressed = leftDown;
+        rightPressed = rightDown;
+
+        // Network: tell the server where we are, take in whatever it sent
+        if (client) {
+            client->poll();
+            if (!spawned && client->isReady()) {
+                camera.setPosition(client->getSpawn() + glm::vec3(0.0f, Player::EYE_HEIGHT, 0.0f));
+                spawned = true;
+            }
+            client->setPosition(camera.getPosition());
+        }
+
+        if (!recordFile.empty()) {
+            path.frames.push_back({ camera.getPosition(), camera.getYaw(), camera.getPitch(), std::move(frameEdits) });
+        }
+
+        // Block ticks (flowing water, grass) at the fixed tick rate, capped
+        // like the player's. In network games the server runs them
+        if (!client) {
+            worldTickAccumulator = std::min(worldTickAccumulator + deltaTime, 0.25f);
+            while (worldTickAccumulator >= Player::TICK_DT) {
+                world.tick();
+                worldTickAccumulator -= Player::TICK_DT;
+            }
+        }
+
         // Update world (load/unload chunks around camera)
-        world.update(camera.getPosition(), 4);
+        world.update(camera.getPosition(), renderDistance);
 
         // Render
         renderer.clear();
         renderer.setViewMatrix(camera.getViewMatrix());
-        world.render(renderer.getShaderProgram());
+        worldRenderer.render(world, renderer, camera.getPosition());
+
+        // Frame budget: what this frame's work took, without waiting on the swap
+        if (adaptive) {
+            double workMs = std::chrono::duration<double, std::milli>(clock::now() - now).count();
+            std::size_t backlog =
+                worldRenderer.getPendingUploads() + world.getPendingLoads() + world.getPendingRelights();
+            if (budget.endFrame(workMs, backlog)) {
+                const BudgetDecision& decision = budget.getLastDecision();
+                budgetLog.write(decision);
+                world.setLoadLimit(budget.getLoadLimit());
+                worldRenderer.setUploadLimit(budget.getUploadLimit());
+                // On a server the view distance was settled when connecting
+                if (!client && decision.renderDistance != renderDistance) {
+                    renderDistance = decision.renderDistance;
+                    std::cout << "Render distance " << renderDistance << ": " << decision.reason << " (mean "
+                              << decision.meanMs << " ms, p90 " << decision.p90Ms << " ms)" << std::endl;
+                }
+            }
+        }
 
         window.swapBuffers();
     }
 
+    if (!recordFile.empty()) {
+        if (!path.save(recordFile)) return 1;
+        std::cout << "Recorded " << path.frames.size() << " frames to " << recordFile << std::endl;
+    }
     return 0;
 }
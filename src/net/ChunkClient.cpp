@@ -0,0 +1,145 @@
+#include "net/ChunkClient.hpp"
+#include "net/ByteBuffer.hpp"
+#include <chrono>
+#include <iostream>
+
+namespace {
+    // Resend the position once the camera moved this far (in blocks)
+    constexpr float POSITION_THRESHOLD = 0.5f;
+}
+
+ChunkClient::ChunkClient() : m_world(0, WorldMode::REMOTE) {}
+
+bool ChunkClient::connect(const std::string& host, uint16_t port, int viewDistance) {
+    m_connection = Connection::connect(host, port);
+    if (!m_connection) return false;
+
+    m_scratch.clear();
+    ByteWriter w(m_scratch);
+    w.u32(Protocol::VERSION);
+    w.u8(static_cast<uint8_t>(viewDistance));
+    m_connection->send(Protocol::MessageType::HELLO, m_scratch);
+    return m_connection->flush();
+}
+
+void ChunkClient::setPosition(const glm::vec3& position) {
+    if (!m_ready || !isConnected()) return;
+    if (m_positionSent && glm::length(position - m_sentPosition) < POSITION_THRESHOLD) return;
+
+    m_scratch.clear();
+    ByteWriter w(m_scratch);
+    w.f32(position.x);
+    w.f32(position.y);
+    w.f32(position.z);
+    m_connection->send(Protocol::MessageType::POSITION, m_scratch);
+    m_sentPosition = position;
+    m_positionSent = true;
+}
+
+void ChunkClient::requestBlockEdit(int x, int y, int z, BlockType type) {
+    if (!m_ready || !isConnected()) return;
+
+    m_scratch.clear();
+    ByteWriter w(m_scratch);
+    w.i32(x);
+    w.i32(y);
+    w.i32(z);
+    w.u8(static_cast<uint8_t>(type));
+    m_connection->send(Protocol::MessageType::BLOCK_EDIT, m_scratch);
+}
+
+void ChunkClient::poll() {
+    if (!m_connection) return;
+    m_connection->flush();
+    m_connection->receive();
+
+    Protocol::MessageType type;
+    std::vector<uint8_t> payload;
+    while (m_connection->nextMessage(type, payload)) {
+        handleMessage(type, payload);
+    }
+
+    // Light and mesh the whole batch together
+    m_world.addChunks(m_received);
+    m_received.clear();
+}
+
+void ChunkClient::handleMessage(Protocol::MessageType type, const std::vector<uint8_t>& payload) {
+    ByteReader r(payload.data(), payload.size());
+
+    switch (type) {
+    case Protocol::MessageType::WELCOME: {
+        int seed = r.i32();
+        int viewDistance = r.u8();
+        glm::vec3 spawn;
+        spawn.x = r.f32();
+        spawn.y = r.f32();
+        spawn.z = r.f32();
+        if (!r.ok()) break;
+        (void)seed; // terrain comes from the server, nothing to generate here
+        m_viewDistance = viewDistance;
+        m_spawn = spawn;
+        m_ready = true;
+        break;
+    }
+    case Protocol::MessageType::CHUNK_DATA: {
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<Chunk> chunk = ChunkCodec::decodeChunk(payload.data(), payload.size(), &m_world.getChunkPool());
+        m_stats.decodeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!chunk) {
+            std::cerr << "Server sent a bad chunk, disconnecting" << std::endl;
+            m_connection->disconnect();
+            break;
+        }
+
+        // The same chunk twice in one batch (unloaded and sent again): keep the newest
+        for (auto& pending : m_received) {
+            if (pending->getChunkX() == chunk->getChunkX() && pending->getChunkZ() == chunk->getChunkZ()) {
+                pending = chunk;
+                chunk = nullptr;
+                break;
+            }
+        }
+        if (chunk) m_received.push_back(std::move(chunk));
+        m_stats.chunksReceived++;
+        m_stats.chunkBytes += payload.size();
+        break;
+    }
+    case Protocol::MessageType::CHUNK_UNLOAD: {
+        int chunkX = r.i32();
+        int chunkZ = r.i32();
+        if (!r.ok()) break;
+        m_world.removeChunk(chunkX, chunkZ);
+        for (auto it = m_received.begin(); it != m_received.end(); ++it) {
+            if ((*it)->getChunkX() == chunkX && (*it)->getChunkZ() == chunkZ) {
+                m_received.erase(it);
+                break;
+            }
+        }
+        m_stats.unloadsReceived++;
+        break;
+    }
+    case Protocol::MessageType::BLOCK_DELTA: {
+        int chunkX, chunkZ;
+        if (!ChunkCodec::decodeDelta(payload.data(), payload.size(), chunkX, chunkZ, m_changes)) {
+            std::cerr << "Server sent a bad block delta, disconnecting" << std::endl;
+            m_connection->disconnect();
+            break;
+        }
+        // Deltas only follow chunks we were sent, which may still be in this batch
+        m_world.addChunks(m_received);
+        m_received.clear();
+
+        for (const BlockChange& c : m_changes) {
+            int x = chunkX * Chunk::WIDTH + c.index % Chunk::WIDTH;
+            int z = chunkZ * Chunk::DEPTH + (c.index / Chunk::WIDTH) % Chunk::DEPTH;
+            int y = c.index / (Chunk::WIDTH * Chunk::DEPTH);
+            m_world.setBlock(x, y, z, c.type);
+        }
+        m_stats.deltasReceived++;
+        break;
+    }
+    default:
+        break;
+    }
+}
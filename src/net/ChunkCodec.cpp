@@ -0,0 +1,164 @@
+#include "net/ChunkCodec.hpp"
+#include "net/ByteBuffer.hpp"
+#include "net/Compression.hpp"
+#include <algorithm>
+
+namespace {
+    constexpr int BLOCK_TYPES = static_cast<int>(BlockType::COUNT);
+
+    // Biggest body a valid chunk can have: every section with a full palette at 8 bits
+    constexpr std::size_t MAX_BODY_SIZE = 2 + Chunk::SECTION_COUNT * (2 + 256 + Chunk::SECTION_VOLUME);
+
+    int bitsFor(int paletteSize) {
+        int bits = 0;
+        while ((1 << bits) < paletteSize) ++bits;
+        return bits;
+    }
+
+    bool isEmpty(const BlockType* blocks) {
+        for (int i = 0; i < Chunk::SECTION_VOLUME; ++i) {
+            if (blocks[i] != BlockType::AIR) return false;
+        }
+        return true;
+    }
+
+    void encodeSection(const BlockType* blocks, ByteWriter& w) {
+        int16_t lookup[256];
+        for (int16_t& l : lookup) l = -1;
+        uint8_t palette[256];
+        int paletteSize = 0;
+        for (int i = 0; i < Chunk::SECTION_VOLUME; ++i) {
+            uint8_t t = static_cast<uint8_t>(blocks[i]);
+            if (lookup[t] < 0) {
+                lookup[t] = static_cast<int16_t>(paletteSize);
+                palette[paletteSize++] = t;
+            }
+        }
+
+        w.u8(static_cast<uint8_t>(paletteSize - 1));
+        w.bytes(palette, paletteSize);
+        int bits = bitsFor(paletteSize);
+        w.u8(static_cast<uint8_t>(bits));
+        if (bits == 0) return;
+
+        int perWord = 64 / bits;
+        for (int i = 0; i < Chunk::SECTION_VOLUME; i += perWord) {
+            uint64_t word = 0;
+            int n = std::min(perWord, Chunk::SECTION_VOLUME - i);
+            for (int k = 0; k < n; ++k) {
+                word |= static_cast<uint64_t>(lookup[static_cast<uint8_t>(blocks[i + k])]) << (k * bits);
+            }
+            w.u64(word);
+        }
+    }
+
+    bool decodeSection(ByteReader& r, BlockType* blocks) {
+        int paletteSize = r.u8() + 1;
+        const uint8_t* palette = r.bytes(paletteSize);
+        int bits = r.u8();
+        if (!palette || bits != bitsFor(paletteSize)) return false;
+        for (int i = 0; i < paletteSize; ++i) {
+            if (palette[i] >= BLOCK_TYPES) return false;
+        }
+
+        if (bits == 0) {
+            for (int i = 0; i < Chunk::SECTION_VOLUME; ++i) blocks[i] = static_cast<BlockType>(palette[0]);
+            return true;
+        }
+
+        int perWord = 64 / bits;
+        uint64_t mask = (uint64_t(1) << bits) - 1;
+        for (int i = 0; i < Chunk::SECTION_VOLUME; i += perWord) {
+            uint64_t word = r.u64();
+            int n = std::min(perWord, Chunk::SECTION_VOLUME - i);
+            for (int k = 0; k < n; ++k) {
+                uint64_t index = (word >> (k * bits)) & mask;
+                if (index >= static_cast<uint64_t>(paletteSize)) return false;
+                blocks[i + k] = static_cast<BlockType>(palette[index]);
+            }
+        }
+        return r.ok();
+    }
+}
+
+namespace ChunkCodec {
+
+void encodeChunk(const Chunk& chunk, std::vector<uint8_t>& out, CodecStats* stats) {
+    std::vector<uint8_t> body;
+    ByteWriter b(body);
+
+    uint16_t mask = 0;
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        if (!isEmpty(chunk.getSectionBlocks(s))) mask |= static_cast<uint16_t>(1u << s);
+    }
+    b.u16(mask);
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        if (mask & (1u << s)) encodeSection(chunk.getSectionBlocks(s), b);
+    }
+
+    std::size_t start = out.size();
+    ByteWriter w(out);
+    w.i32(chunk.getChunkX());
+    w.i32(chunk.getChunkZ());
+    w.varint(static_cast<uint32_t>(body.size()));
+    Lz::compress(body.data(), body.size(), out);
+
+    if (stats) {
+        stats->chunks++;
+        stats->rawBytes += Chunk::VOLUME;
+        stats->packedBytes += body.size();
+        stats->compressedBytes += out.size() - start;
+    }
+}
+
+std::shared_ptr<Chunk> decodeChunk(const uint8_t* data, std::size_t size, ChunkPool* pool) {
+    ByteReader r(data, size);
+    int chunkX = r.i32();
+    int chunkZ = r.i32();
+    uint32_t bodySize = r.varint();
+    if (!r.ok() || bodySize < 2 || bodySize > MAX_BODY_SIZE) return nullptr;
+
+    std::vector<uint8_t> body(bodySize);
+    std::size_t compressedSize = r.remaining();
+    if (!Lz::decompress(r.bytes(compressedSize), compressedSize, body.data(), body.size())) return nullptr;
+
+    auto chunk = pool ? pool->acquire(chunkX, chunkZ) : std::make_shared<Chunk>(chunkX, chunkZ);
+    ByteReader b(body.data(), body.size());
+    uint16_t mask = b.u16();
+    for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+        if ((mask & (1u << s)) && !decodeSection(b, chunk->getSectionBlocks(s))) return nullptr;
+    }
+    if (!b.ok() || b.remaining() != 0) return nullptr;
+    return chunk;
+}
+
+void encodeDelta(int chunkX, int chunkZ, const std::vector<BlockChange>& changes, std::vector<uint8_t>& out) {
+    ByteWriter w(out);
+    w.i32(chunkX);
+    w.i32(chunkZ);
+    w.varint(static_cast<uint32_t>(changes.size()));
+    for (const BlockChange& c : changes) {
+        w.u16(c.index);
+        w.u8(static_cast<uint8_t>(c.type));
+    }
+}
+
+bool decodeDelta(const uint8_t* data, std::size_t size, int& chunkX, int& chunkZ, std::vector<BlockChange>& changes) {
+    ByteReader r(data, size);
+    chunkX = r.i32();
+    chunkZ = r.i32();
+    uint32_t count = r.varint();
+    if (!r.ok() || count > r.remaining() / 3) return false;
+
+    changes.clear();
+    changes.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint16_t index = r.u16();
+        uint8_t type = r.u8();
+        if (type >= BLOCK_TYPES) return false;
+        changes.push_back({ index, static_cast<BlockType>(type) });
+    }
+    return r.ok() && r.remaining() == 0;
+}
+
+} // namespace ChunkCodec
@@ -0,0 +1,233 @@
+#include "net/ChunkServer.hpp"
+#include "net/ByteBuffer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+ChunkServer::ChunkServer(Simulation& sim) : m_sim(sim) {}
+
+bool ChunkServer::listen(uint16_t port) {
+    m_listener = Listener::listen(port);
+    return m_listener != nullptr;
+}
+
+void ChunkServer::tick() {
+    acceptClients();
+    for (Client& client : m_clients) readClient(client);
+
+    // Drop clients that went away
+    for (auto it = m_clients.begin(); it != m_clients.end();) {
+        if (it->connection->isOpen()) {
+            ++it;
+        } else {
+            if (it->ready) m_sim.removeViewer(it->viewer);
+            it = m_clients.erase(it);
+        }
+    }
+
+    m_sim.tick();
+    for (const TickChange& c : m_sim.getWorld().getBlockTicks().getChanges()) recordEdit(c.x, c.y, c.z, c.type);
+
+    // Forget encodings of chunks the world unloaded (or replaced)
+    World& world = m_sim.getWorld();
+    if (world.getChunkEpoch() != m_cacheEpoch) {
+        m_cacheEpoch = world.getChunkEpoch();
+        for (auto it = m_cache.begin(); it != m_cache.end();) {
+            int chunkX = static_cast<int>(it->first >> 32);
+            int chunkZ = static_cast<int>(static_cast<int32_t>(it->first & 0xFFFFFFFF));
+            if (world.findChunk(chunkX, chunkZ) == it->second.chunk) ++it;
+            else it = m_cache.erase(it);
+        }
+    }
+
+    sendEdits();
+    for (Client& client : m_clients) {
+        if (client.ready) streamChunks(client);
+        client.connection->flush();
+    }
+}
+
+bool ChunkServer::flush() {
+    bool done = true;
+    for (Client& client : m_clients) {
+        if (client.connection->flush() && client.connection->getPendingBytes() > 0) done = false;
+    }
+    return done;
+}
+
+void ChunkServer::setBlock(int x, int y, int z, BlockType type) {
+    if (m_sim.getWorld().setBlock(x, y, z, type)) recordEdit(x, y, z, type);
+}
+
+void ChunkServer::recordEdit(int x, int y, int z, BlockType type) {
+    int chunkX = World::toChunkCoord(x, Chunk::WIDTH);
+    int chunkZ = World::toChunkCoord(z, Chunk::DEPTH);
+    int lx = x - chunkX * Chunk::WIDTH;
+    int lz = z - chunkZ * Chunk::DEPTH;
+    int64_t key = chunkKey(chunkX, chunkZ);
+    uint16_t index = static_cast<uint16_t>(y * (Chunk::WIDTH * Chunk::DEPTH) + lz * Chunk::WIDTH + lx);
+    m_edits[key].push_back({ index, type });
+    m_cache.erase(key);
+}
+
+void ChunkServer::acceptClients() {
+    if (!m_listener) return;
+    while (std::unique_ptr<Connection> connection = m_listener->accept()) {
+        Client client;
+        client.connection = std::move(connection);
+        m_clients.push_back(std::move(client));
+    }
+}
+
+void ChunkServer::readClient(Client& client) {
+    client.connection->receive();
+    Protocol::MessageType type;
+    std::vector<uint8_t> payload;
+    while (client.connection->nextMessage(type, payload)) {
+        handleMessage(client, type, payload);
+    }
+}
+
+void ChunkServer::handleMessage(Client& client, Protocol::MessageType type, const std::vector<uint8_t>& payload) {
+    ByteReader r(payload.data(), payload.size());
+    World& world = m_sim.getWorld();
+
+    switch (type) {
+    case Protocol::MessageType::HELLO: {
+        uint32_t version = r.u32();
+        int viewDistance = r.u8();
+        if (!r.ok() || client.ready || version != Protocol::VERSION) {
+            std::cerr << "Client sent a bad HELLO, dropping it" << std::endl;
+            client.connection->disconnect();
+            return;
+        }
+        client.viewDistance = std::max(1, std::min(viewDistance, m_sim.getViewDistance()));
+
+        // Spawn on the ground in the middle of chunk (0, 0)
+        world.getOrCreateChunk(0, 0);
+        int y = Chunk::HEIGHT - 1;
+        while (y > 0 && !isSolid(world.getBlock(8, y, 8))) --y;
+        glm::vec3 spawn(8.0f, y + 0.5f, 8.0f);
+
+        client.viewer = m_sim.addViewer(spawn);
+        client.ready = true;
+        client.chunkX = 0;
+        client.chunkZ = 0;
+
+        m_scratch.clear();
+        ByteWriter w(m_scratch);
+        w.i32(world.getSeed());
+        w.u8(static_cast<uint8_t>(client.viewDistance));
+        w.f32(spawn.x);
+        w.f32(spawn.y);
+        w.f32(spawn.z);
+        client.connection->send(Protocol::MessageType::WELCOME, m_scratch);
+        break;
+    }
+    case Protocol::MessageType::POSITION: {
+        glm::vec3 pos;
+        pos.x = r.f32();
+        pos.y = r.f32();
+        pos.z = r.f32();
+        if (!r.ok() || !client.ready || !std::isfinite(pos.x) || !std::isfinite(pos.z)) return;
+        m_sim.setViewerPosition(client.viewer, pos);
+
+        int chunkX = static_cast<int>(std::floor(pos.x / Chunk::WIDTH));
+        int chunkZ = static_cast<int>(std::floor(pos.z / Chunk::DEPTH));
+        if (chunkX != client.chunkX || chunkZ != client.chunkZ) {
+            client.chunkX = chunkX;
+            client.chunkZ = chunkZ;
+            client.complete = false;
+        }
+        break;
+    }
+    case Protocol::MessageType::BLOCK_EDIT: {
+        int x = r.i32(), y = r.i32(), z = r.i32();
+        uint8_t block = r.u8();
+        if (!r.ok() || !client.ready || block >= static_cast<uint8_t>(BlockType::COUNT)) return;
+        // Only chunks the client can actually see
+        int chunkX = World::toChunkCoord(x, Chunk::WIDTH);
+        int chunkZ = World::toChunkCoord(z, Chunk::DEPTH);
+        if (!client.sent.count(chunkKey(chunkX, chunkZ))) return;
+        setBlock(x, y, z, static_cast<BlockType>(block));
+        break;
+    }
+    default:
+        // Unknown or server-only message, ignore it
+        break;
+    }
+}
+
+void ChunkServer::streamChunks(Client& client) {
+    if (client.complete) return;
+
+    // Unload what's fallen out of view (one extra ring of slack against thrashing)
+    int keep = client.viewDistance + 1;
+    for (auto it = client.sent.begin(); it != client.sent.end();) {
+        int chunkX = static_cast<int>(*it >> 32);
+        int chunkZ = static_cast<int>(static_cast<int32_t>(*it & 0xFFFFFFFF));
+        if (std::abs(chunkX - client.chunkX) <= keep && std::abs(chunkZ - client.chunkZ) <= keep) {
+            ++it;
+            continue;
+        }
+        m_scratch.clear();
+        ByteWriter w(m_scratch);
+        w.i32(chunkX);
+        w.i32(chunkZ);
+        client.connection->send(Protocol::MessageType::CHUNK_UNLOAD, m_scratch);
+        it = client.sent.erase(it);
+    }
+
+    // Nearest first, ring by ring
+    World& world = m_sim.getWorld();
+    int budget = MAX_CHUNKS_PER_TICK;
+    bool missing = false;
+    for (int r = 0; r <= client.viewDistance; ++r) {
+        for (int dz = -r; dz <= r; ++dz) {
+            for (int dx = -r; dx <= r; ++dx) {
+                if (std::max(std::abs(dx), std::abs(dz)) != r) continue;
+                int chunkX = client.chunkX + dx;
+                int chunkZ = client.chunkZ + dz;
+                int64_t key = chunkKey(chunkX, chunkZ);
+                if (client.sent.count(key)) continue;
+
+                const Chunk* chunk = world.findChunk(chunkX, chunkZ);
+                if (!chunk || budget == 0 || client.connection->getPendingBytes() > MAX_PENDING_BYTES) {
+                    missing = true;
+                    continue;
+                }
+                client.connection->send(Protocol::MessageType::CHUNK_DATA, encoded(*chunk));
+                client.sent.insert(key);
+                ++m_chunksSent;
+                --budget;
+            }
+        }
+    }
+    client.complete = !missing;
+}
+
+void ChunkServer::sendEdits() {
+    for (const auto& [key, changes] : m_edits) {
+        int chunkX = static_cast<int>(key >> 32);
+        int chunkZ = static_cast<int>(static_cast<int32_t>(key & 0xFFFFFFFF));
+        m_scratch.clear();
+        ChunkCodec::encodeDelta(chunkX, chunkZ, changes, m_scratch);
+        for (Client& client : m_clients) {
+            if (client.ready && client.sent.count(key)) {
+                client.connection->send(Protocol::MessageType::BLOCK_DELTA, m_scratch);
+            }
+        }
+    }
+    m_edits.clear();
+}
+
+const std::vector<uint8_t>& ChunkServer::encoded(const Chunk& chunk) {
+    CachedChunk& cached = m_cache[chunkKey(chunk.getChunkX(), chunk.getChunkZ())];
+    if (cached.chunk != &chunk || cached.payload.empty()) {
+        cached.chunk = &chunk;
+        cached.payload.clear();
+        ChunkCodec::encodeChunk(chunk, cached.payload, &m_codecStats);
+    }
+    return cached.payload;
+}
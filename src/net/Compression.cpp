@@ -0,0 +1,132 @@
+#include "net/Compression.hpp"
+#include <array>
+#include <cstring>
+
+namespace {
+    constexpr int HASH_BITS = 14;
+    constexpr std::size_t MIN_MATCH = 4;
+    constexpr std::size_t MAX_OFFSET = 65535;
+    // Like LZ4: the last 5 bytes are always literals and no match starts in the
+    // last 12, so the decoder can't be tricked into a match running off the end
+    constexpr std::size_t LAST_LITERALS = 5;
+    constexpr std::size_t MATCH_LIMIT = 12;
+
+    inline uint32_t read32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    inline uint32_t hashOf(uint32_t v) {
+        return (v * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    // 15 in the token nibble means "more length bytes follow", 255 per byte until one isn't
+    void writeLength(std::vector<uint8_t>& out, std::size_t len) {
+        for (len -= 15; len >= 255; len -= 255) out.push_back(255);
+        out.push_back(static_cast<uint8_t>(len));
+    }
+
+    bool readLength(const uint8_t* src, std::size_t size, std::size_t& ip, std::size_t& len) {
+        uint8_t b;
+        do {
+            if (ip >= size) return false;
+            b = src[ip++];
+            len += b;
+        } while (b == 255);
+        return true;
+    }
+
+    void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, std::size_t literalCount,
+                       std::size_t offset, std::size_t matchLength) {
+        std::size_t m = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+        uint8_t token = static_cast<uint8_t>(((literalCount < 15 ? literalCount : 15) << 4) | (m < 15 ? m : 15));
+        out.push_back(token);
+        if (literalCount >= 15) writeLength(out, literalCount);
+        out.insert(out.end(), literals, literals + literalCount);
+        if (matchLength == 0) return; // last sequence, literals only
+
+        out.push_back(static_cast<uint8_t>(offset));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (m >= 15) writeLength(out, m);
+    }
+}
+
+namespace Lz {
+
+void compress(const uint8_t* src, std::size_t size, std::vector<uint8_t>& out) {
+    out.reserve(out.size() + compressBound(size));
+
+    std::array<int32_t, 1 << HASH_BITS> table;
+    table.fill(-1);
+
+    std::size_t anchor = 0; // start of the literals not written yet
+    std::size_t i = 0;
+    std::size_t limit = size > MATCH_LIMIT ? size - MATCH_LIMIT : 0;
+
+    while (i < limit) {
+        uint32_t seq = read32(src + i);
+        uint32_t h = hashOf(seq);
+        int32_t candidate = table[h];
+        table[h] = static_cast<int32_t>(i);
+
+        if (candidate < 0 || i - candidate > MAX_OFFSET || read32(src + candidate) != seq) {
+            ++i;
+            continue;
+        }
+
+        std::size_t match = static_cast<std::size_t>(candidate);
+        std::size_t len = MIN_MATCH;
+        while (i + len < size - LAST_LITERALS && src[match + len] == src[i + len]) ++len;
+
+        // Grow the match backwards into the pending literals
+        while (i > anchor && match > 0 && src[i - 1] == src[match - 1]) {
+            --i;
+            --match;
+            ++len;
+        }
+
+        writeSequence(out, src + anchor, i - anchor, i - match, len);
+        i += len;
+        anchor = i;
+
+        // Seed the table inside the match so the next one can start right away
+        if (i >= 2 && i - 2 < limit) table[hashOf(read32(src + i - 2))] = static_cast<int32_t>(i - 2);
+    }
+
+    writeSequence(out, src + anchor, size - anchor, 0, 0);
+}
+
+bool decompress(const uint8_t* src, std::size_t size, uint8_t* dst, std::size_t dstSize) {
+    std::size_t ip = 0, op = 0;
+    while (ip < size) {
+        uint8_t token = src[ip++];
+
+        std::size_t literals = token >> 4;
+        if (literals == 15 && !readLength(src, size, ip, literals)) return false;
+        if (literals > size - ip || literals > dstSize - op) return false;
+        if (literals > 0) std::memcpy(dst + op, src + ip, literals);
+        ip += literals;
+        op += literals;
+
+        if (ip == size) break; // last sequence has no match
+
+        if (size - ip < 2) return false;
+        std::size_t offset = src[ip] | (static_cast<std::size_t>(src[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+
+        std::size_t len = token & 15;
+        if (len == 15 && !readLength(src, size, ip, len)) return false;
+        len += MIN_MATCH;
+        if (len > dstSize - op) return false;
+
+        // Byte by byte: the match may overlap what it's copying (runs)
+        const uint8_t* from = dst + op - offset;
+        for (std::size_t k = 0; k < len; ++k) dst[op + k] = from[k];
+        op += len;
+    }
+    return op == dstSize;
+}
+
+} // namespace Lz
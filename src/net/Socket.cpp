@@ -0,0 +1,192 @@
+#include "net/Socket.hpp"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    constexpr std::size_t HEADER_SIZE = 5; // u32 length + u8 type
+
+    // Writing to a peer that hung up raises SIGPIPE, which kills the process.
+    // Linux turns it off per send(), macOS per socket (see configure())
+#ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    constexpr int SEND_FLAGS = 0;
+#endif
+
+    void configure(int fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        // Lots of small position updates, don't sit on them
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef __APPLE__
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    }
+
+    uint32_t readU32(const uint8_t* p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+}
+
+Connection::Connection(int fd) : m_fd(fd) {
+    configure(m_fd);
+}
+
+Connection::~Connection() {
+    disconnect();
+}
+
+std::unique_ptr<Connection> Connection::connect(const std::string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    std::string service = std::to_string(port);
+    if (int err = getaddrinfo(host.c_str(), service.c_str(), &hints, &results)) {
+        std::cerr << "Can't resolve " << host << ": " << gai_strerror(err) << std::endl;
+        return nullptr;
+    }
+
+    int fd = -1;
+    for (addrinfo* a = results; a; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(results);
+
+    if (fd < 0) {
+        std::cerr << "Can't connect to " << host << ":" << port << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    return std::make_unique<Connection>(fd);
+}
+
+void Connection::disconnect() {
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+}
+
+void Connection::send(Protocol::MessageType type, const std::vector<uint8_t>& payload) {
+    // Drop the already-written front once it's most of the buffer
+    if (m_outboxHead > 0 && m_outboxHead * 2 >= m_outbox.size()) {
+        m_outbox.erase(m_outbox.begin(), m_outbox.begin() + m_outboxHead);
+        m_outboxHead = 0;
+    }
+
+    uint32_t length = static_cast<uint32_t>(payload.size() + 1);
+    for (int i = 0; i < 4; ++i) m_outbox.push_back(static_cast<uint8_t>(length >> (8 * i)));
+    m_outbox.push_back(static_cast<uint8_t>(type));
+    m_outbox.insert(m_outbox.end(), payload.begin(), payload.end());
+}
+
+bool Connection::flush() {
+    while (m_fd >= 0 && m_outboxHead < m_outbox.size()) {
+        ssize_t n = ::send(m_fd, m_outbox.data() + m_outboxHead, m_outbox.size() - m_outboxHead, SEND_FLAGS);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            disconnect();
+            break;
+        }
+        m_outboxHead += static_cast<std::size_t>(n);
+        m_bytesSent += static_cast<uint64_t>(n);
+    }
+    if (m_outboxHead == m_outbox.size()) {
+        m_outbox.clear();
+        m_outboxHead = 0;
+    }
+    return isOpen();
+}
+
+bool Connection::receive() {
+    uint8_t buffer[64 * 1024];
+    while (m_fd >= 0) {
+        ssize_t n = ::recv(m_fd, buffer, sizeof(buffer), 0);
+        if (n == 0) {
+            disconnect(); // peer hung up
+        } else if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno != EINTR) disconnect();
+        } else {
+            m_inbox.insert(m_inbox.end(), buffer, buffer + n);
+            m_bytesReceived += static_cast<uint64_t>(n);
+        }
+    }
+    // Messages already in the inbox can still be read after a disconnect
+    return isOpen();
+}
+
+bool Connection::nextMessage(Protocol::MessageType& type, std::vector<uint8_t>& payload) {
+    std::size_t available = m_inbox.size() - m_inboxHead;
+    if (available < HEADER_SIZE) return false;
+
+    const uint8_t* header = m_inbox.data() + m_inboxHead;
+    uint32_t length = readU32(header);
+    if (length == 0 || length > Protocol::MAX_MESSAGE_SIZE) {
+        // Garbage on the stream, nothing after this can be trusted
+        disconnect();
+        m_inbox.clear();
+        m_inboxHead = 0;
+        return false;
+    }
+    if (available < 4 + static_cast<std::size_t>(length)) return false;
+
+    type = static_cast<Protocol::MessageType>(header[4]);
+    payload.assign(header + HEADER_SIZE, header + 4 + length);
+    m_inboxHead += 4 + length;
+
+    if (m_inboxHead == m_inbox.size()) {
+        m_inbox.clear();
+        m_inboxHead = 0;
+    } else if (m_inboxHead * 2 >= m_inbox.size()) {
+        m_inbox.erase(m_inbox.begin(), m_inbox.begin() + m_inboxHead);
+        m_inboxHead = 0;
+    }
+    return true;
+}
+
+Listener::~Listener() {
+    if (m_fd >= 0) ::close(m_fd);
+}
+
+std::unique_ptr<Listener> Listener::listen(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "Can't create socket: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 64) < 0) {
+        std::cerr << "Can't listen on port " << port << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return nullptr;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return std::unique_ptr<Listener>(new Listener(fd, ntohs(addr.sin_port)));
+}
+
+std::unique_ptr<Connection> Listener::accept() {
+    int fd = ::accept(m_fd, nullptr, nullptr);
+    if (fd < 0) return nullptr;
+    return std::make_unique<Connection>(fd);
+}
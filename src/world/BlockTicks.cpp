@@ -0,0 +1,287 @@
+#include "world/BlockTicks.hpp"
+#include "world/World.hpp"
+#include <algorithm>
+
+namespace {
+    // Horizontal neighbors, same order as the mesher's faces: -X, +X, -Z, +Z
+    constexpr int SIDES[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+    // Chunk coords get 22 bits each in a wheel entry, biased to stay positive
+    constexpr int CHUNK_BITS = 22;
+    constexpr int CHUNK_BIAS = 1 << (CHUNK_BITS - 1);
+    constexpr uint64_t CHUNK_MASK = (uint64_t(1) << CHUNK_BITS) - 1;
+
+    bool isFlowingWater(BlockType type) {
+        return type != BlockType::WATER && waterLevel(type) > 0;
+    }
+}
+
+uint64_t BlockTicks::pack(int x, int y, int z) {
+    int chunkX = World::toChunkCoord(x, Chunk::WIDTH);
+    int chunkZ = World::toChunkCoord(z, Chunk::DEPTH);
+    return (static_cast<uint64_t>(chunkX + CHUNK_BIAS) & CHUNK_MASK) << (16 + CHUNK_BITS) |
+           (static_cast<uint64_t>(chunkZ + CHUNK_BIAS) & CHUNK_MASK) << 16 |
+           static_cast<uint64_t>(y) << 8 |
+           static_cast<uint64_t>(z - chunkZ * Chunk::DEPTH) << 4 |
+           static_cast<uint64_t>(x - chunkX * Chunk::WIDTH);
+}
+
+void BlockTicks::unpack(uint64_t key, int& x, int& y, int& z) {
+    int chunkX = static_cast<int>((key >> (16 + CHUNK_BITS)) & CHUNK_MASK) - CHUNK_BIAS;
+    int chunkZ = static_cast<int>((key >> 16) & CHUNK_MASK) - CHUNK_BIAS;
+    y = static_cast<int>((key >> 8) & 255);
+    z = chunkZ * Chunk::DEPTH + static_cast<int>((key >> 4) & 15);
+    x = chunkX * Chunk::WIDTH + static_cast<int>(key & 15);
+}
+
+void BlockTicks::schedule(int x, int y, int z, int delay) {
+    if (y < 0 || y >= Chunk::HEIGHT || m_world.getMode() == WorldMode::REMOTE) return;
+    delay = std::clamp(delay, 1, WHEEL_SLOTS - 1);
+    m_wheel[(m_tick + delay) % WHEEL_SLOTS].push_back(pack(x, y, z));
+    ++m_pending;
+}
+
+void BlockTicks::onBlockChanged(int x, int y, int z) {
+    if (m_world.getMode() == WorldMode::REMOTE) return;
+    static constexpr int AROUND[7][3] = {
+        { 0, 0, 0 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, 0, -1 }, { 0, 0, 1 }, { 0, -1, 0 }, { 0, 1, 0 },
+    };
+    for (const auto& d : AROUND) {
+        if (waterLevel(m_world.getBlock(x + d[0], y + d[1], z + d[2])) > 0) {
+            schedule(x + d[0], y + d[1], z + d[2], WATER_DELAY);
+        }
+    }
+}
+
+void BlockTicks::onBoxChanged(const BlockBox& box) {
+    if (box.empty() || m_world.getMode() == WorldMode::REMOTE) return;
+    BlockBox around(box.min - glm::ivec3(1), box.max + glm::ivec3(1));
+    int minY = std::max(around.min.y, 0);
+    int maxY = std::min(around.max.y, Chunk::HEIGHT - 1);
+
+    // One chunk at a time so the reads stay in the neighborhood
+    int cx0 = World::toChunkCoord(around.min.x, Chunk::WIDTH), cx1 = World::toChunkCoord(around.max.x, Chunk::WIDTH);
+    int cz0 = World::toChunkCoord(around.min.z, Chunk::DEPTH), cz1 = World::toChunkCoord(around.max.z, Chunk::DEPTH);
+    for (int cz = cz0; cz <= cz1; ++cz) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            int ox = cx * Chunk::WIDTH, oz = cz * Chunk::DEPTH;
+            if (!focus(ox, oz)) continue;
+            const Chunk& chunk = *m_area.chunkAt(ox, oz);
+            int x0 = std::max(around.min.x, ox), x1 = std::min(around.max.x, ox + Chunk::WIDTH - 1);
+            int z0 = std::max(around.min.z, oz), z1 = std::min(around.max.z, oz + Chunk::DEPTH - 1);
+            for (int y = minY; y <= maxY; ++y) {
+                for (int z = z0; z <= z1; ++z) {
+                    for (int x = x0; x <= x1; ++x) {
+                        BlockType type = chunk.getBlock(x - ox, y, z - oz);
+                        if (waterLevel(type) == 0) continue;
+                        // Flowing water may have lost what fed it, a source
+                        // only matters if it has somewhere to go
+                        if (type != BlockType::WATER || canSpread(x, y, z)) schedule(x, y, z, WATER_DELAY);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void BlockTicks::onChunkLoaded(int chunkX, int chunkZ) {
+    if (m_world.getMode() == WorldMode::REMOTE) return;
+    // Water in the loaded neighbors' columns along this chunk stopped there
+    // waiting for it (see tickWater()). Only theirs: water generated with the
+    // new chunk stays as it was generated until something changes next to it
+    for (const auto& s : SIDES) {
+        int ox = (chunkX + s[0]) * Chunk::WIDTH, oz = (chunkZ + s[1]) * Chunk::DEPTH;
+        if (!focus(ox, oz)) continue;
+        const Chunk& chunk = *m_area.chunkAt(ox, oz);
+        // The neighbor's edge facing this chunk: x or z fixed, the other 0..15
+        int fixed = s[0] + s[1] < 0 ? 15 : 0;
+        for (int y = 0; y < Chunk::HEIGHT; ++y) {
+            for (int i = 0; i < 16; ++i) {
+                int lx = s[0] ? fixed : i, lz = s[0] ? i : fixed;
+                BlockType type = chunk.getBlock(lx, y, lz);
+                if (waterLevel(type) == 0) continue;
+                if (type != BlockType::WATER || canSpread(ox + lx, y, oz + lz)) schedule(ox + lx, y, oz + lz, WATER_DELAY);
+            }
+        }
+    }
+}
+
+void BlockTicks::tick() {
+    ++m_tick;
+    m_changes.clear();
+    m_lastUpdates = 0;
+    m_lastRandomHits = 0;
+    if (m_world.getMode() == WorldMode::REMOTE) return;
+
+    runScheduled();
+    runRandom();
+}
+
+void BlockTicks::runScheduled() {
+    std::vector<uint64_t>& bucket = m_wheel[m_tick % WHEEL_SLOTS];
+    if (bucket.empty() && m_overflow.empty()) return;
+    m_pending -= bucket.size();
+
+    // Sorted, so every block runs once and the result doesn't depend on the
+    // order things were scheduled in
+    std::sort(bucket.begin(), bucket.end());
+    bucket.erase(std::unique(bucket.begin(), bucket.end()), bucket.end());
+
+    // What earlier ticks had no room for runs first, in the order it was
+    // due. Merged into the sorted bucket instead, the chunks that sort last
+    // would never get a turn for as long as the backlog lasts. A block that
+    // is still waiting there keeps its place and isn't added a second time
+    if (!m_overflow.empty() && !bucket.empty()) {
+        m_waiting.assign(m_overflow.begin(), m_overflow.end());
+        std::sort(m_waiting.begin(), m_waiting.end());
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                    [this](uint64_t key) {
+                                        return std::binary_search(m_waiting.begin(), m_waiting.end(), key);
+                                    }),
+                     bucket.end());
+    }
+    m_due.swap(m_overflow);
+    m_due.insert(m_due.end(), bucket.begin(), bucket.end());
+    bucket.clear();
+
+    std::size_t count = std::min(m_due.size(), MAX_UPDATES_PER_TICK);
+    for (std::size_t i = 0; i < count; ++i) {
+        int x, y, z;
+        unpack(m_due[i], x, y, z);
+        if (!focus(x, z)) continue; // unloaded since, drop it
+        if (waterLevel(get(x, y, z)) > 0) tickWater(x, y, z);
+    }
+    m_lastUpdates = count;
+
+    // Over budget: the rest go first next tick
+    m_overflow.assign(m_due.begin() + count, m_due.end());
+    m_due.clear();
+}
+
+void BlockTicks::runRandom() {
+    // Pick first, react after - reacting writes blocks, picking walks the chunk map
+    m_randomHits.clear();
+    m_world.forEachChunk([this](const Chunk& chunk) {
+        int baseX = chunk.getChunkX() * Chunk::WIDTH;
+        int baseZ = chunk.getChunkZ() * Chunk::DEPTH;
+        for (int section = 0; section < Chunk::SECTION_COUNT; ++section) {
+            for (int i = 0; i < RANDOM_TICKS_PER_SECTION; ++i) {
+                uint32_t r = m_rng();
+                int x = r & 15;
+                int z = (r >> 4) & 15;
+                int y = section * Chunk::SECTION_HEIGHT + ((r >> 8) & 15);
+                if (hasRandomTicks(chunk.getBlock(x, y, z))) m_randomHits.emplace_back(baseX + x, y, baseZ + z);
+            }
+        }
+    });
+
+    for (const glm::ivec3& p : m_randomHits) {
+        if (!focus(p.x, p.z)) continue;
+        if (get(p.x, p.y, p.z) == BlockType::GRASS) tickGrass(p.x, p.y, p.z);
+    }
+    m_lastRandomHits = m_randomHits.size();
+}
+
+bool BlockTicks::focus(int x, int z) {
+    int chunkX = World::toChunkCoord(x, Chunk::WIDTH);
+    int chunkZ = World::toChunkCoord(z, Chunk::DEPTH);
+    if (chunkX != m_area.getCenterX() || chunkZ != m_area.getCenterZ() || m_area.isStale(m_world)) {
+        m_area.reset(m_world, chunkX, chunkZ);
+    }
+    return m_area.chunkAt(x, z) != nullptr;
+}
+
+BlockType BlockTicks::get(int x, int y, int z) const {
+    return m_area.getBlock(x, y, z);
+}
+
+void BlockTicks::set(int x, int y, int z, BlockType type) {
+    // Light, remesh flags and waking the water around it all happen in there
+    if (!m_world.setBlock(x, y, z, type)) return;
+    m_changes.push_back({ x, y, z, type });
+}
+
+int BlockTicks::feedLevel(int x, int y, int z) const {
+    if (y + 1 < Chunk::HEIGHT && waterLevel(get(x, y + 1, z)) > 0) return WATER_SOURCE_LEVEL - 1;
+    int best = 0;
+    for (const auto& s : SIDES) {
+        int level = waterLevel(get(x + s[0], y, z + s[1]));
+        if (level > best + 1 && spreadsSideways(x + s[0], y, z + s[1])) best = level - 1;
+    }
+    return best;
+}
+
+bool BlockTicks::canSpread(int x, int y, int z) const {
+    if (y > 0) {
+        BlockType below = get(x, y - 1, z);
+        if (below == BlockType::AIR || isFlowingWater(below)) return true;
+    }
+    int next = waterLevel(get(x, y, z)) - 1;
+    for (const auto& s : SIDES) {
+        if (canFlowInto(get(x + s[0], y, z + s[1]), next)) return true;
+    }
+    return false;
+}
+
+bool BlockTicks::spreadsSideways(int x, int y, int z) const {
+    if (y == 0) return true;
+    BlockType below = get(x, y - 1, z);
+    return below != BlockType::AIR && !isFlowingWater(below);
+}
+
+void BlockTicks::tickWater(int x, int y, int z) {
+    // Water next to an unloaded chunk waits, the missing side reads as air.
+    // onChunkLoaded() wakes it when the chunk comes in
+    for (const auto& s : SIDES) {
+        if (!m_area.chunkAt(x + s[0], z + s[1])) return;
+    }
+
+    BlockType type = get(x, y, z);
+    int level = waterLevel(type);
+    if (type != BlockType::WATER) {
+        int target = feedLevel(x, y, z);
+        if (target != level) {
+            // Wakes this block and its neighbors again, so a change ripples on
+            set(x, y, z, target > 0 ? flowingWater(target) : BlockType::AIR);
+            if (target == 0) return;
+            level = target;
+        }
+    }
+
+    // Falling first, sideways only once it lands
+    if (y > 0) {
+        BlockType below = get(x, y - 1, z);
+        if (below == BlockType::AIR || isFlowingWater(below)) {
+            if (canFlowInto(below, WATER_SOURCE_LEVEL - 1)) set(x, y - 1, z, flowingWater(WATER_SOURCE_LEVEL - 1));
+            return;
+        }
+    }
+
+    int next = level - 1;
+    if (next < 1) return;
+    for (const auto& s : SIDES) {
+        if (canFlowInto(get(x + s[0], y, z + s[1]), next)) set(x + s[0], y, z + s[1], flowingWater(next));
+    }
+}
+
+void BlockTicks::tickGrass(int x, int y, int z) {
+    // Covered up: back to dirt
+    if (y + 1 < Chunk::HEIGHT && isSolid(get(x, y + 1, z))) {
+        set(x, y, z, BlockType::DIRT);
+        return;
+    }
+
+    // Spread to one random dirt block nearby that's uncovered and lit
+    uint32_t r = m_rng();
+    int tx = x + static_cast<int>(r % 3) - 1;
+    int ty = y + static_cast<int>((r >> 2) % 5) - 3;
+    int tz = z + static_cast<int>((r >> 5) % 3) - 1;
+    if (ty < 0 || ty + 1 >= Chunk::HEIGHT || get(tx, ty, tz) != BlockType::DIRT) return;
+    if (isSolid(get(tx, ty + 1, tz))) return;
+
+    const Chunk* chunk = m_area.chunkAt(tx, tz);
+    int lx = tx - chunk->getChunkX() * Chunk::WIDTH;
+    int lz = tz - chunk->getChunkZ() * Chunk::DEPTH;
+    int light = std::max(chunk->getSkyLight(lx, ty + 1, lz), chunk->getBlockLight(lx, ty + 1, lz));
+    if (light >= 9) set(tx, ty, tz, BlockType::GRASS);
+}
@@ -1,18 +1,37 @@
 #include "world/Chunk.hpp"
-#include <glad/glad.h>
-#include <glm/gtc/matrix_transform.hpp>
+#include "world/ChunkNeighborhood.hpp"
+#include "core/MemoryTracker.hpp"
+#include <algorithm>
 #include <array>
+#include <cmath>
 
 Chunk::Chunk(int chunkX, int chunkZ)
     : m_chunkX(chunkX), m_chunkZ(chunkZ) {
     // Initialize block storage with AIR
-    m_blocks.resize(VOLUME, BlockType::AIR);
+    m_blocks.fill(BlockType::AIR);
+    // Dark until the light engine gets to it
+    m_light.fill(0);
+
+    MemoryTracker::add(MemoryCategory::BLOCKS, sizeof(m_blocks), 1);
+    MemoryTracker::add(MemoryCategory::LIGHT, sizeof(m_light), 1);
 }
 
 Chunk::~Chunk() {
-    if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
-    if (m_VBO) glDeleteBuffers(1, &m_VBO);
-    if (m_EBO) glDeleteBuffers(1, &m_EBO);
+    MemoryTracker::add(MemoryCategory::BLOCKS, -static_cast<int64_t>(sizeof(m_blocks)), -1);
+    MemoryTracker::add(MemoryCategory::LIGHT, -static_cast<int64_t>(sizeof(m_light)), -1);
+    MemoryTracker::add(MemoryCategory::MESH_CPU, -static_cast<int64_t>(m_meshBytes), m_hasPendingMesh ? -1 : 0);
+}
+
+void Chunk::reset(int chunkX, int chunkZ) {
+    m_chunkX = chunkX;
+    m_chunkZ = chunkZ;
+    m_blocks.fill(BlockType::AIR);
+    m_light.fill(0);
+
+    if (m_hasPendingMesh) MemoryTracker::add(MemoryCategory::MESH_CPU, 0, -1);
+    m_hasPendingMesh = false;
+    m_pendingMesh.clear();
+    m_dirty = false;
 }
 
 BlockType Chunk::getBlock(int x, int y, int z) const {
@@ -50,158 +69,195 @@ bool Chunk::isBlockVisible(int x, int y, int z) const {
     return false;
 }
 
-void Chunk::generateMesh() {
-    // Clean up old mesh if it exists
-    if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
-    if (m_VBO) glDeleteBuffers(1, &m_VBO);
-    if (m_EBO) glDeleteBuffers(1, &m_EBO);
-
-    std::vector<float> vertices; // Position (x,y,z) + Color (r,g,b) = 6 floats per vertex
-    std::vector<unsigned int> indices;
-
-    // Face color for a block — grass gets different colors per face
-    auto getFaceColor = [](BlockType type, int face) -> std::array<float, 3> {
-        const auto& data = BlockDB::get(type);
-        if (type == BlockType::GRASS) {
-            if (face == 5) return {0.2f, 0.8f, 0.2f};       // top: green
-            if (face == 4) return {0.55f, 0.36f, 0.23f};     // bottom: dirt
-            return {0.45f, 0.6f, 0.2f};                       // sides: greenish-brown
+namespace {
+    // One entry per face, in mesher order: -X, +X, -Z, +Z, -Y, +Y
+    // corners are the sign of each vertex's offset from the block center,
+    // listed in the order the quad is wound
+    struct FaceDef {
+        int normal[3];
+        int corners[4][3];
+    };
+
+    const FaceDef FACES[FACE_COUNT] = {
+        { { -1,  0,  0 }, { { -1, -1, -1 }, { -1, -1,  1 }, { -1,  1,  1 }, { -1,  1, -1 } } },
+        { {  1,  0,  0 }, { {  1, -1,  1 }, {  1, -1, -1 }, {  1,  1, -1 }, {  1,  1,  1 } } },
+        { {  0,  0, -1 }, { {  1, -1, -1 }, { -1, -1, -1 }, { -1,  1, -1 }, {  1,  1, -1 } } },
+        { {  0,  0,  1 }, { { -1, -1,  1 }, {  1, -1,  1 }, {  1,  1,  1 }, { -1,  1,  1 } } },
+        { {  0, -1,  0 }, { { -1, -1,  1 }, { -1, -1, -1 }, {  1, -1, -1 }, {  1, -1,  1 } } },
+        { {  0,  1,  0 }, { { -1,  1, -1 }, {  1,  1, -1 }, {  1,  1,  1 }, { -1,  1,  1 } } },
+    };
+
+    // Ambient occlusion level (0 = fully occluded, 3 = open) -> brightness
+    constexpr float AO_CURVE[4] = { 0.5f, 0.7f, 0.85f, 1.0f };
+}
+
+void Chunk::buildMesh(const ChunkNeighborhood* neighbors, ChunkMeshData& out, bool ambientOcclusion,
+                      MeshFormat format) const {
+    out.clear();
+    out.format = format;
+    std::vector<float>& vertices = out.vertices;
+    std::vector<unsigned int>& indices = out.indices;
+    std::vector<uint32_t>& faces = out.faces;
+
+    // Light level -> brightness, each level down is 80% as bright as the one above
+    static const std::array<float, MAX_LIGHT + 1> lightCurve = [] {
+        std::array<float, MAX_LIGHT + 1> curve{};
+        for (int i = 0; i <= MAX_LIGHT; ++i) {
+            curve[i] = std::max(std::pow(0.8f, static_cast<float>(MAX_LIGHT - i)), 0.05f);
         }
-        return {data.color[0], data.color[1], data.color[2]};
+        return curve;
+    }();
+
+    // Chunk that owns local (x, z), which may be past the border
+    // nullptr if that neighbor isn't loaded (or we weren't given neighbors)
+    auto ownerOf = [&](int x, int z) -> const Chunk* {
+        if (x >= 0 && x < WIDTH && z >= 0 && z < DEPTH) return this;
+        return neighbors ? neighbors->chunkAt(m_chunkX * WIDTH + x, m_chunkZ * DEPTH + z) : nullptr;
     };
 
-    // Helper to emit a face quad (4 verts, 6 indices)
-    auto addFace = [&](float x0, float y0, float z0,
-                       float x1, float y1, float z1,
-                       float x2, float y2, float z2,
-                       float x3, float y3, float z3,
-                       const std::array<float, 3>& color) {
-        unsigned int base = vertices.size() / 6;
-        // 4 vertices
-        float verts[] = { x0,y0,z0, x1,y1,z1, x2,y2,z2, x3,y3,z3 };
-        for (int i = 0; i < 4; ++i) {
-            vertices.push_back(verts[i*3]);
-            vertices.push_back(verts[i*3+1]);
-            vertices.push_back(verts[i*3+2]);
-            vertices.push_back(color[0]);
-            vertices.push_back(color[1]);
-            vertices.push_back(color[2]);
+    // Does the block at local (x, y, z) hide faces / darken the corners next to it
+    auto occludes = [&](int x, int y, int z) -> bool {
+        if (static_cast<unsigned>(y) >= static_cast<unsigned>(HEIGHT)) return false;
+        if (static_cast<unsigned>(x) < static_cast<unsigned>(WIDTH) &&
+            static_cast<unsigned>(z) < static_cast<unsigned>(DEPTH)) {
+            return isSolid(m_blocks[getBlockIndex(x, y, z)]);
         }
-        // 2 triangles (CCW winding)
-        indices.push_back(base);
-        indices.push_back(base + 1);
-        indices.push_back(base + 2);
-        indices.push_back(base + 2);
-        indices.push_back(base + 3);
-        indices.push_back(base);
+        const Chunk* owner = ownerOf(x, z);
+        if (!owner) return false;
+        return isSolid(owner->getBlock(x - (owner->m_chunkX - m_chunkX) * WIDTH, y,
+                                       z - (owner->m_chunkZ - m_chunkZ) * DEPTH));
+    };
+
+    // Light level of a face, from the light in the cell it faces
+    // Cells past the chunk border come from the neighbor (open sky if it isn't loaded)
+    auto faceLight = [&](int x, int y, int z) -> uint8_t {
+        uint8_t sky = MAX_LIGHT;
+        uint8_t block = 0;
+        if (y < 0) {
+            sky = 0;
+        } else if (y < HEIGHT) {
+            if (const Chunk* owner = ownerOf(x, z)) {
+                int lx = x - (owner->m_chunkX - m_chunkX) * WIDTH;
+                int lz = z - (owner->m_chunkZ - m_chunkZ) * DEPTH;
+                sky = owner->getSkyLight(lx, y, lz);
+                block = owner->getBlockLight(lx, y, lz);
+            }
+        }
+        return std::max(sky, block);
     };
 
     // Iterate through all blocks — only emit faces adjacent to non-solid blocks
     for (int y = 0; y < HEIGHT; ++y) {
         for (int z = 0; z < DEPTH; ++z) {
             for (int x = 0; x < WIDTH; ++x) {
-                BlockType blockType = getBlock(x, y, z);
+                BlockType blockType = m_blocks[getBlockIndex(x, y, z)];
                 if (!isSolid(blockType)) continue;
 
                 float wx = static_cast<float>(m_chunkX * WIDTH + x);
                 float wy = static_cast<float>(y);
                 float wz = static_cast<float>(m_chunkZ * DEPTH + z);
 
-                // -X face
-                if (!isNeighborSolid(x - 1, y, z)) {
-                    auto c = getFaceColor(blockType, 0);
-                    addFace(wx-0.5f, wy-0.5f, wz-0.5f,
-                            wx-0.5f, wy-0.5f, wz+0.5f,
-                            wx-0.5f, wy+0.5f, wz+0.5f,
-                            wx-0.5f, wy+0.5f, wz-0.5f, c);
-                }
-                // +X face
-                if (!isNeighborSolid(x + 1, y, z)) {
-                    auto c = getFaceColor(blockType, 1);
-                    addFace(wx+0.5f, wy-0.5f, wz+0.5f,
-                            wx+0.5f, wy-0.5f, wz-0.5f,
-                            wx+0.5f, wy+0.5f, wz-0.5f,
-                            wx+0.5f, wy+0.5f, wz+0.5f, c);
-                }
-                // -Z face
-                if (!isNeighborSolid(x, y, z - 1)) {
-                    auto c = getFaceColor(blockType, 2);
-                    addFace(wx+0.5f, wy-0.5f, wz-0.5f,
-                            wx-0.5f, wy-0.5f, wz-0.5f,
-                            wx-0.5f, wy+0.5f, wz-0.5f,
-                            wx+0.5f, wy+0.5f, wz-0.5f, c);
-                }
-                // +Z face
-                if (!isNeighborSolid(x, y, z + 1)) {
-                    auto c = getFaceColor(blockType, 3);
-                    addFace(wx-0.5f, wy-0.5f, wz+0.5f,
-                            wx+0.5f, wy-0.5f, wz+0.5f,
-                            wx+0.5f, wy+0.5f, wz+0.5f,
-                            wx-0.5f, wy+0.5f, wz+0.5f, c);
-                }
-                // -Y face (bottom)
-                if (!isNeighborSolid(x, y - 1, z)) {
-                    auto c = getFaceColor(blockType, 4);
-                    addFace(wx-0.5f, wy-0.5f, wz+0.5f,
-                            wx-0.5f, wy-0.5f, wz-0.5f,
-                            wx+0.5f, wy-0.5f, wz-0.5f,
-                            wx+0.5f, wy-0.5f, wz+0.5f, c);
-                }
-                // +Y face (top)
-                if (!isNeighborSolid(x, y + 1, z)) {
-                    auto c = getFaceColor(blockType, 5);
-                    addFace(wx-0.5f, wy+0.5f, wz-0.5f,
-                            wx+0.5f, wy+0.5f, wz-0.5f,
-                            wx+0.5f, wy+0.5f, wz+0.5f,
-                            wx-0.5f, wy+0.5f, wz+0.5f, c);
-                }
-            }
-        }
-    }
-
-    m_indexCount = indices.size();
-
-    // If no visible blocks, skip GPU upload
-    if (m_indexCount == 0) {
-        return;
-    }
-
-    // Upload to GPU
-    glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_VBO);
-    glGenBuffers(1, &m_EBO);
+                for (int f = 0; f < FACE_COUNT; ++f) {
+                    const FaceDef& face = FACES[f];
+                    // Cell the face looks into
+                    int nx = x + face.normal[0];
+                    int ny = y + face.normal[1];
+                    int nz = z + face.normal[2];
+                    // Culled against the neighbor chunks too when we have them,
+                    // faces toward a chunk that isn't loaded are kept
+                    if (occludes(nx, ny, nz)) continue;
 
-    glBindVertexArray(m_VAO);
+                    uint8_t light = faceLight(nx, ny, nz);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+                    // Per-vertex AO: the two side cells and the diagonal cell next to
+                    // each corner, one layer out from the face. The 4 corners share
+                    // the 8 cells around the face cell, so sample those once
+                    int ao[4] = { 3, 3, 3, 3 };
+                    if (ambientOcclusion) {
+                        int axis = face.normal[0] ? 0 : (face.normal[1] ? 1 : 2);
+                        int t1 = axis == 0 ? 1 : 0;
+                        int t2 = axis == 2 ? 1 : 2;
+                        bool ring[3][3]; // [t2 offset + 1][t1 offset + 1]
+                        for (int b = -1; b <= 1; ++b) {
+                            for (int a = -1; a <= 1; ++a) {
+                                if (a == 0 && b == 0) continue;
+                                int c[3] = { nx, ny, nz };
+                                c[t1] += a;
+                                c[t2] += b;
+                                ring[b + 1][a + 1] = occludes(c[0], c[1], c[2]);
+                            }
+                        }
+                        for (int v = 0; v < 4; ++v) {
+                            int a = face.corners[v][t1] + 1;
+                            int b = face.corners[v][t2] + 1;
+                            bool side1 = ring[1][a];
+                            bool side2 = ring[b][1];
+                            bool corner = ring[b][a];
+                            ao[v] = (side1 && side2) ? 0 : 3 - (side1 + side2 + corner);
+                        }
+                    }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+                    // 2 triangles (CCW winding). Split along the diagonal through the
+                    // darker pair of corners so the AO gradient doesn't come out lopsided
+                    bool flipped = ao[0] + ao[2] > ao[1] + ao[3];
 
-    // Vertex position attribute (location 0): 3 floats, offset 0
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+                    if (format == MeshFormat::FACES) {
+                        faces.push_back(static_cast<uint32_t>(x) | static_cast<uint32_t>(z) << 4 |
+                                        static_cast<uint32_t>(y) << 8 | static_cast<uint32_t>(f) << 16 |
+                                        static_cast<uint32_t>(blockType) << 19 | static_cast<uint32_t>(flipped) << 27);
+                        faces.push_back(static_cast<uint32_t>(ao[0] | ao[1] << 2 | ao[2] << 4 | ao[3] << 6) |
+                                        static_cast<uint32_t>(light) << 8);
+                        continue;
+                    }
 
-    // Vertex color attribute (location 1): 3 floats, offset 3*sizeof(float)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+                    const BlockColor& color = BlockRegistry::faceColor(blockType, f);
+                    float brightness = lightCurve[light];
+                    unsigned int base = vertices.size() / 6;
+                    for (int v = 0; v < 4; ++v) {
+                        float shade = brightness * AO_CURVE[ao[v]];
+                        vertices.push_back(wx + face.corners[v][0] * 0.5f);
+                        vertices.push_back(wy + face.corners[v][1] * 0.5f);
+                        vertices.push_back(wz + face.corners[v][2] * 0.5f);
+                        vertices.push_back(color.r * shade);
+                        vertices.push_back(color.g * shade);
+                        vertices.push_back(color.b * shade);
+                    }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+                    if (flipped) {
+                        unsigned int quad[6] = { base + 1, base + 2, base + 3, base + 3, base, base + 1 };
+                        indices.insert(indices.end(), quad, quad + 6);
+                    } else {
+                        unsigned int quad[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+                        indices.insert(indices.end(), quad, quad + 6);
+                    }
+                }
+            }
+        }
+    }
 }
 
-void Chunk::render(unsigned int shaderProgram, const glm::mat4& modelMatrix) const {
-    if (m_indexCount == 0) return; // No mesh to render
-
-    glUseProgram(shaderProgram);
+void Chunk::generateMesh(const ChunkNeighborhood* neighbors, MeshFormat format) {
+    buildMesh(neighbors, m_pendingMesh, true, format);
+    if (!m_hasPendingMesh) MemoryTracker::add(MemoryCategory::MESH_CPU, 0, 1);
+    m_hasPendingMesh = true;
+    m_dirty = false;
+    trackMeshMemory();
+}
 
-    // Set model matrix uniform
-    int modelLoc = glGetUniformLocation(shaderProgram, "model");
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &modelMatrix[0][0]);
+bool Chunk::takePendingMesh(ChunkMeshData& out) {
+    if (!m_hasPendingMesh) return false;
+    m_hasPendingMesh = false;
+    std::swap(out, m_pendingMesh);
+    m_pendingMesh.clear();
+    MemoryTracker::add(MemoryCategory::MESH_CPU, 0, -1);
+    trackMeshMemory();
+    return true;
+}
 
-    glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+void Chunk::trackMeshMemory() {
+    std::size_t bytes = m_pendingMesh.capacityBytes();
+    MemoryTracker::add(MemoryCategory::MESH_CPU, static_cast<int64_t>(bytes) - static_cast<int64_t>(m_meshBytes));
+    m_meshBytes = bytes;
 }
 
 glm::vec3 Chunk::getWorldPosition() const {
@@ -0,0 +1,20 @@
+#include "world/ChunkNeighborhood.hpp"
+#include "world/World.hpp"
+
+void ChunkNeighborhood::reset(const World& world, int centerX, int centerZ) {
+    m_centerX = centerX;
+    m_centerZ = centerZ;
+    m_originX = (centerX - 1) * Chunk::WIDTH;
+    m_originZ = (centerZ - 1) * Chunk::DEPTH;
+    m_epoch = world.getChunkEpoch();
+
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            m_chunks[dz + 1][dx + 1] = world.findChunk(centerX + dx, centerZ + dz);
+        }
+    }
+}
+
+bool ChunkNeighborhood::isStale(const World& world) const {
+    return m_epoch != world.getChunkEpoch();
+}
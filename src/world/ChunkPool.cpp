@@ -0,0 +1,38 @@
+#include "world/ChunkPool.hpp"
+#include <new>
+
+// Raw storage for a slab's chunks, constructed in place by grow()
+struct ChunkPool::Slab {
+    alignas(Chunk) unsigned char storage[SLAB_CHUNKS][sizeof(Chunk)];
+
+    Slab() {} // leave the storage uninitialized, the chunks fill it in
+};
+
+std::shared_ptr<Chunk> ChunkPool::acquire(int chunkX, int chunkZ) {
+    // Free = only the pool holds it. Start after the last one handed out,
+    // the chunks before it are the most likely to still be in use
+    for (std::size_t n = 0; n < m_chunks.size(); ++n) {
+        std::size_t i = (m_cursor + n) % m_chunks.size();
+        if (m_chunks[i].use_count() == 1) {
+            m_cursor = i + 1;
+            m_chunks[i]->reset(chunkX, chunkZ);
+            return m_chunks[i];
+        }
+    }
+
+    m_cursor = m_chunks.size();
+    grow();
+    std::shared_ptr<Chunk>& chunk = m_chunks[m_cursor++];
+    chunk->reset(chunkX, chunkZ);
+    return chunk;
+}
+
+void ChunkPool::grow() {
+    auto slab = std::make_shared<Slab>();
+    m_chunks.reserve(m_chunks.size() + SLAB_CHUNKS);
+    for (std::size_t i = 0; i < SLAB_CHUNKS; ++i) {
+        Chunk* chunk = new (slab->storage[i]) Chunk(0, 0);
+        // Each chunk holds on to its slab, the slab goes with the last of them
+        m_chunks.emplace_back(chunk, [slab](Chunk* c) { c->~Chunk(); });
+    }
+}
@@ -0,0 +1,326 @@
+#include "world/Lighting.hpp"
+#include "world/World.hpp"
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace {
+    // Same face order as the mesher: -X, +X, -Z, +Z, -Y, +Y
+    constexpr int DIRS[6][3] = {
+        { -1, 0, 0 }, { 1, 0, 0 }, { 0, 0, -1 }, { 0, 0, 1 }, { 0, -1, 0 }, { 0, 1, 0 },
+    };
+    constexpr int DOWN = 4;
+
+    // Center chunk starts this far into the neighborhood on x and z
+    constexpr int CX = Chunk::WIDTH;
+    constexpr int CZ = Chunk::DEPTH;
+
+    inline int unpackX(uint32_t e) { return static_cast<int>(e & 63); }
+    inline int unpackZ(uint32_t e) { return static_cast<int>((e >> 6) & 63); }
+    inline int unpackY(uint32_t e) { return static_cast<int>((e >> 12) & 255); }
+    inline uint8_t unpackLevel(uint32_t e) { return static_cast<uint8_t>((e >> 20) & 15); }
+}
+
+void LightEngine::focus(int chunkX, int chunkZ) {
+    if (chunkX != m_area.getCenterX() || chunkZ != m_area.getCenterZ() || m_area.isStale(m_world)) {
+        m_area.reset(m_world, chunkX, chunkZ);
+    }
+}
+
+void LightEngine::markChanged(int x, int z) {
+    m_area.chunkAtLocal(x, z)->markDirty();
+    int lx = x % Chunk::WIDTH;
+    int lz = z % Chunk::DEPTH;
+    Chunk* next = nullptr;
+    if (lx == 0 && (next = m_area.chunkAtLocal(x - 1, z))) next->markDirty();
+    if (lx == Chunk::WIDTH - 1 && (next = m_area.chunkAtLocal(x + 1, z))) next->markDirty();
+    if (lz == 0 && (next = m_area.chunkAtLocal(x, z - 1))) next->markDirty();
+    if (lz == Chunk::DEPTH - 1 && (next = m_area.chunkAtLocal(x, z + 1))) next->markDirty();
+}
+
+template <bool Sky>
+uint8_t LightEngine::read(int x, int y, int z) const {
+    const Chunk* chunk = m_area.chunkAtLocal(x, z);
+    int lx = x % Chunk::WIDTH;
+    int lz = z % Chunk::DEPTH;
+    return Sky ? chunk->getSkyLight(lx, y, lz) : chunk->getBlockLight(lx, y, lz);
+}
+
+template <bool Sky>
+void LightEngine::write(int x, int y, int z, uint8_t level) {
+    Chunk* chunk = m_area.chunkAtLocal(x, z);
+    int lx = x % Chunk::WIDTH;
+    int lz = z % Chunk::DEPTH;
+    if (Sky) chunk->setSkyLight(lx, y, lz, level);
+    else chunk->setBlockLight(lx, y, lz, level);
+    markChanged(x, z);
+}
+
+template <bool Sky>
+void LightEngine::propagate() {
+    for (std::size_t head = 0; head < m_addQueue.size(); ++head) {
+        uint32_t e = m_addQueue[head];
+        int x = unpackX(e), y = unpackY(e), z = unpackZ(e);
+        if (!m_area.chunkAtLocal(x, z)) continue;
+
+        uint8_t level = read<Sky>(x, y, z);
+        if (level <= 1) continue;
+
+        for (int d = 0; d < 6; ++d) {
+            int nx = x + DIRS[d][0], ny = y + DIRS[d][1], nz = z + DIRS[d][2];
+            if (ny < 0 || ny >= Chunk::HEIGHT) continue;
+            const Chunk* chunk = m_area.chunkAtLocal(nx, nz);
+            if (!chunk) continue;
+
+            uint8_t opacity = lightOpacity(chunk->getBlock(nx % Chunk::WIDTH, ny, nz % Chunk::DEPTH));
+            if (opacity >= Chunk::MAX_LIGHT) continue;
+
+            // Full sky light falls straight down through clear blocks without fading
+            uint8_t loss = std::max<uint8_t>(opacity, 1);
+            uint8_t next;
+            if (Sky && d == DOWN && level == Chunk::MAX_LIGHT && opacity == 0) next = level;
+            else next = level > loss ? static_cast<uint8_t>(level - loss) : 0;
+
+            if (next > read<Sky>(nx, ny, nz)) {
+                write<Sky>(nx, ny, nz, next);
+                m_addQueue.push_back(pack(nx, ny, nz));
+            }
+        }
+    }
+    m_addQueue.clear();
+}
+
+template <bool Sky>
+void LightEngine::unpropagate() {
+    for (std::size_t head = 0; head < m_removeQueue.size(); ++head) {
+        uint32_t e = m_removeQueue[head];
+        int x = unpackX(e), y = unpackY(e), z = unpackZ(e);
+        uint8_t level = unpackLevel(e);
+
+        for (int d = 0; d < 6; ++d) {
+            int nx = x + DIRS[d][0], ny = y + DIRS[d][1], nz = z + DIRS[d][2];
+            if (ny < 0 || ny >= Chunk::HEIGHT) continue;
+            const Chunk* chunk = m_area.chunkAtLocal(nx, nz);
+            if (!chunk) continue;
+
+            uint8_t neighbor = read<Sky>(nx, ny, nz);
+            if (neighbor == 0) continue;
+
+            bool litByUs = neighbor < level ||
+                (Sky && d == DOWN && level == Chunk::MAX_LIGHT && neighbor == Chunk::MAX_LIGHT);
+            if (litByUs) {
+                write<Sky>(nx, ny, nz, 0);
+                m_removeQueue.push_back(pack(nx, ny, nz, neighbor));
+
+                // Light sources we just darkened keep shining
+                if (!Sky) {
+                    uint8_t emission = lightEmission(chunk->getBlock(nx % Chunk::WIDTH, ny, nz % Chunk::DEPTH));
+                    if (emission > 0) {
+                        write<Sky>(nx, ny, nz, emission);
+                        m_addQueue.push_back(pack(nx, ny, nz));
+                    }
+                }
+            } else {
+                // Lit from somewhere else - spread back into the removed area
+                m_addQueue.push_back(pack(nx, ny, nz));
+            }
+        }
+    }
+    m_removeQueue.clear();
+}
+
+template <bool Sky>
+void LightEngine::seedFromNeighbors() {
+    // Border cells of the 4 side neighbors, as (start x, start z, step x, step z)
+    // plus which way the center chunk is from there
+    const int borders[4][5] = {
+        { CX - 1, CZ, 0, 1, 1 },             // -X neighbor, its east edge
+        { CX + Chunk::WIDTH, CZ, 0, 1, -1 }, // +X neighbor, its west edge
+        { CX, CZ - 1, 1, 0, 1 },             // -Z neighbor, its south edge
+        { CX, CZ + Chunk::DEPTH, 1, 0, -1 }, // +Z neighbor, its north edge
+    };
+    for (const auto& b : borders) {
+        if (!m_area.chunkAtLocal(b[0], b[1])) continue;
+        int inX = b[3] * b[4]; // step from the border cell into the center chunk
+        int inZ = b[2] * b[4];
+        for (int i = 0; i < 16; ++i) {
+            int x = b[0] + b[2] * i;
+            int z = b[1] + b[3] * i;
+            for (int y = 0; y < Chunk::HEIGHT; ++y) {
+                // Only cells that would brighten the cell across the border
+                if (read<Sky>(x, y, z) > read<Sky>(x + inX, y, z + inZ) + 1) {
+                    m_addQueue.push_back(pack(x, y, z));
+                }
+            }
+        }
+    }
+}
+
+void LightEngine::lightColumns(Chunk& chunk) {
+    for (int z = 0; z < Chunk::DEPTH; ++z) {
+        for (int x = 0; x < Chunk::WIDTH; ++x) {
+            uint8_t level = Chunk::MAX_LIGHT;
+            for (int y = Chunk::HEIGHT - 1; y >= 0; --y) {
+                // Same falloff as propagate(): only full sky light passes air for free
+                uint8_t opacity = lightOpacity(chunk.getBlock(x, y, z));
+                if (level < Chunk::MAX_LIGHT || opacity > 0) {
+                    uint8_t loss = std::max<uint8_t>(opacity, 1);
+                    level = level > loss ? static_cast<uint8_t>(level - loss) : 0;
+                }
+                if (level == 0) break;
+                chunk.setSkyLight(x, y, z, level);
+            }
+        }
+    }
+}
+
+void LightEngine::spreadChunk(Chunk& chunk) {
+    m_area.reset(m_world, chunk.getChunkX(), chunk.getChunkZ());
+
+    // Lowest fully sky-lit y of a column anywhere in the neighborhood
+    auto columnBottom = [&](int x, int z) -> int {
+        if (!m_area.chunkAtLocal(x, z)) return 0;
+        int y = Chunk::HEIGHT;
+        while (y > 0 && read<true>(x, y - 1, z) == Chunk::MAX_LIGHT) --y;
+        return y;
+    };
+
+    int bottom[Chunk::DEPTH][Chunk::WIDTH];
+    for (int z = 0; z < Chunk::DEPTH; ++z) {
+        for (int x = 0; x < Chunk::WIDTH; ++x) {
+            bottom[z][x] = columnBottom(CX + x, CZ + z);
+        }
+    }
+    auto bottomAt = [&](int x, int z) -> int {
+        int lx = x - CX, lz = z - CZ;
+        if (lx >= 0 && lx < Chunk::WIDTH && lz >= 0 && lz < Chunk::DEPTH) return bottom[lz][lx];
+        return columnBottom(x, z);
+    };
+
+    // Only the lit cells that sit next to a darker column need to spread sideways
+    // (including lit cells under water, which are dimmer than full sky)
+    for (int z = 0; z < Chunk::DEPTH; ++z) {
+        for (int x = 0; x < Chunk::WIDTH; ++x) {
+            int top = bottom[z][x];
+            for (int d = 0; d < 4; ++d) {
+                top = std::max(top, bottomAt(CX + x + DIRS[d][0], CZ + z + DIRS[d][2]));
+            }
+            int y = bottom[z][x];
+            while (y > 0 && chunk.getSkyLight(x, y - 1, z) > 0) --y;
+            for (; y < top; ++y) {
+                m_addQueue.push_back(pack(CX + x, y, CZ + z));
+            }
+        }
+    }
+    seedFromNeighbors<true>();
+    propagate<true>();
+
+    // Block light from anything that glows
+    for (int y = 0; y < Chunk::HEIGHT; ++y) {
+        for (int z = 0; z < Chunk::DEPTH; ++z) {
+            for (int x = 0; x < Chunk::WIDTH; ++x) {
+                uint8_t emission = lightEmission(chunk.getBlock(x, y, z));
+                if (emission > 0) {
+                    chunk.setBlockLight(x, y, z, emission);
+                    m_addQueue.push_back(pack(CX + x, y, CZ + z));
+                }
+            }
+        }
+    }
+    seedFromNeighbors<false>();
+    propagate<false>();
+}
+
+void LightEngine::onBlockChanged(int x, int y, int z) {
+    if (y < 0 || y >= Chunk::HEIGHT) return;
+    glm::ivec3 block(x, y, z);
+    relightBlocks(&block, 1);
+}
+
+void LightEngine::onBlocksChanged(std::vector<glm::ivec3>& blocks, std::size_t maxChunks) {
+    if (maxChunks == 0) {
+        relightChunks(blocks);
+        blocks.clear();
+        return;
+    }
+
+    // The first maxChunks chunks to show up in blocks go now, the rest keep
+    // their order for the next call, so nothing waits behind newer changes
+    m_picked.clear();
+    m_batch.clear();
+    std::size_t kept = 0;
+    for (const glm::ivec3& b : blocks) {
+        std::pair<int, int> chunk(World::toChunkCoord(b.x, Chunk::WIDTH), World::toChunkCoord(b.z, Chunk::DEPTH));
+        bool picked = std::find(m_picked.begin(), m_picked.end(), chunk) != m_picked.end();
+        if (!picked && m_picked.size() < maxChunks) {
+            m_picked.push_back(chunk);
+            picked = true;
+        }
+        if (picked) m_batch.push_back(b);
+        else blocks[kept++] = b;
+    }
+    blocks.resize(kept);
+    relightChunks(m_batch);
+}
+
+void LightEngine::relightChunks(std::vector<glm::ivec3>& blocks) {
+    auto chunkOf = [](const glm::ivec3& b) {
+        return std::make_pair(World::toChunkCoord(b.x, Chunk::WIDTH), World::toChunkCoord(b.z, Chunk::DEPTH));
+    };
+    auto before = [&](const glm::ivec3& a, const glm::ivec3& b) {
+        auto ca = chunkOf(a), cb = chunkOf(b);
+        if (ca != cb) return ca < cb;
+        return std::tie(a.y, a.z, a.x) < std::tie(b.y, b.z, b.x);
+    };
+    std::sort(blocks.begin(), blocks.end(), before);
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+
+    // One pass per chunk, that's as far as the neighborhood reaches
+    for (std::size_t first = 0; first < blocks.size();) {
+        std::size_t last = first + 1;
+        while (last < blocks.size() && chunkOf(blocks[last]) == chunkOf(blocks[first])) ++last;
+        relightBlocks(&blocks[first], last - first);
+        first = last;
+    }
+}
+
+void LightEngine::relightBlocks(const glm::ivec3* blocks, std::size_t count) {
+    focus(World::toChunkCoord(blocks[0].x, Chunk::WIDTH), World::toChunkCoord(blocks[0].z, Chunk::DEPTH));
+    if (!m_area.chunkAtLocal(CX, CZ)) return;
+    relight<true>(blocks, count);
+    relight<false>(blocks, count);
+}
+
+template <bool Sky>
+void LightEngine::relight(const glm::ivec3* blocks, std::size_t count) {
+    // Drop whatever was there, then let the surroundings flow back in
+    for (std::size_t i = 0; i < count; ++i) {
+        int lx = blocks[i].x - m_area.getOriginX();
+        int lz = blocks[i].z - m_area.getOriginZ();
+        m_removeQueue.push_back(pack(lx, blocks[i].y, lz, read<Sky>(lx, blocks[i].y, lz)));
+        write<Sky>(lx, blocks[i].y, lz, 0);
+    }
+    unpropagate<Sky>();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        int lx = blocks[i].x - m_area.getOriginX();
+        int lz = blocks[i].z - m_area.getOriginZ();
+        int y = blocks[i].y;
+        BlockType type = m_area.getBlock(blocks[i].x, y, blocks[i].z);
+        uint8_t level = 0;
+        if (Sky) {
+            // Nothing above the top of the world to flow in from
+            if (y == Chunk::HEIGHT - 1 && lightOpacity(type) < Chunk::MAX_LIGHT) {
+                level = Chunk::MAX_LIGHT - lightOpacity(type);
+            }
+        } else {
+            // The new block may glow
+            level = lightEmission(type);
+        }
+        if (level > 0) {
+            write<Sky>(lx, y, lz, level);
+            m_addQueue.push_back(pack(lx, y, lz));
+        }
+    }
+    propagate<Sky>();
+}
@@ -0,0 +1,149 @@
+#include "world/Player.hpp"
+#include "world/World.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Keeps boxes from ending up exactly flush with a block face,
+    // which would make the next overlap test ambiguous
+    constexpr float SKIN = 1e-4f;
+
+    // Blocks are centered on integer coords, block n covers n-0.5 .. n+0.5
+    inline int cellMin(float v) { return static_cast<int>(std::floor(v + 0.5f)); }
+    inline int cellMax(float v) { return static_cast<int>(std::floor(v + 0.5f - SKIN)); }
+}
+
+Player::Player(const glm::vec3& position)
+    : m_position(position), m_prevPosition(position) {}
+
+void Player::setPosition(const glm::vec3& position) {
+    m_position = position;
+    m_prevPosition = position;
+    m_velocity = glm::vec3(0.0f);
+    m_onGround = false;
+}
+
+AABB Player::boundsAt(const glm::vec3& position) {
+    float half = WIDTH * 0.5f;
+    return { position - glm::vec3(half, 0.0f, half),
+             position + glm::vec3(half, HEIGHT, half) };
+}
+
+bool Player::isSolidAt(int x, int y, int z) const {
+    if (y < 0) return true;
+    if (y >= Chunk::HEIGHT) return false;
+    const Chunk* chunk = m_chunks.chunkAt(x, z);
+    if (!chunk) return true;
+    return isSolid(chunk->getBlock(x - chunk->getChunkX() * Chunk::WIDTH, y,
+                                   z - chunk->getChunkZ() * Chunk::DEPTH));
+}
+
+float Player::clipAxis(const AABB& box, int axis, float delta) const {
+    if (delta == 0.0f) return 0.0f;
+    const float wanted = delta;
+
+    // Broadphase: only the cells the box sweeps through on this axis
+    glm::vec3 lo = box.min;
+    glm::vec3 hi = box.max;
+    if (delta > 0.0f) hi[axis] += delta;
+    else lo[axis] += delta;
+
+    int x0 = cellMin(lo.x), x1 = cellMax(hi.x);
+    int y0 = cellMin(lo.y), y1 = cellMax(hi.y);
+    int z0 = cellMin(lo.z), z1 = cellMax(hi.z);
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int z = z0; z <= z1; ++z) {
+            for (int x = x0; x <= x1; ++x) {
+                if (!isSolidAt(x, y, z)) continue;
+
+                glm::ivec3 cell(x, y, z);
+                float blockMin = static_cast<float>(cell[axis]) - 0.5f;
+                float blockMax = static_cast<float>(cell[axis]) + 0.5f;
+                if (delta > 0.0f && blockMin >= box.max[axis] - SKIN) {
+                    delta = std::min(delta, blockMin - box.max[axis] - SKIN);
+                } else if (delta < 0.0f && blockMax <= box.min[axis] + SKIN) {
+                    delta = std::max(delta, blockMax - box.min[axis] + SKIN);
+                }
+            }
+        }
+    }
+
+    // Already touching: don't let the skin push the box backwards
+    return wanted > 0.0f ? std::max(delta, 0.0f) : std::min(delta, 0.0f);
+}
+
+glm::vec3 Player::sweep(AABB& box, const glm::vec3& delta) const {
+    glm::vec3 moved(0.0f);
+    static const int order[3] = { 1, 0, 2 };
+    for (int axis : order) {
+        float d = clipAxis(box, axis, delta[axis]);
+        box.min[axis] += d;
+        box.max[axis] += d;
+        moved[axis] = d;
+    }
+    return moved;
+}
+
+void Player::tick(World& world, const PlayerInput& input) {
+    m_prevPosition = m_position;
+
+    int chunkX = World::toChunkCoord(cellMin(m_position.x), Chunk::WIDTH);
+    int chunkZ = World::toChunkCoord(cellMin(m_position.z), Chunk::DEPTH);
+    if (chunkX != m_chunks.getCenterX() || chunkZ != m_chunks.getCenterZ() || m_chunks.isStale(world)) {
+        m_chunks.reset(world, chunkX, chunkZ);
+    }
+
+    // Desired horizontal velocity from input, relative to where we're facing
+    float yaw = glm::radians(input.yaw);
+    glm::vec3 forward(std::cos(yaw), 0.0f, std::sin(yaw));
+    glm::vec3 right(-forward.z, 0.0f, forward.x);
+    glm::vec3 wish = forward * input.forward + right * input.strafe;
+    float wishLen = glm::length(wish);
+    if (wishLen > 1.0f) wish /= wishLen;
+    wish *= WALK_SPEED;
+
+    // Full control on the ground, only a little steering in the air
+    float control = m_onGround ? 1.0f : AIR_CONTROL;
+    m_velocity.x += (wish.x - m_velocity.x) * control;
+    m_velocity.z += (wish.z - m_velocity.z) * control;
+
+    if (input.jump && m_onGround) {
+        m_velocity.y = JUMP_VELOCITY;
+    }
+    m_velocity.y = std::max(m_velocity.y - GRAVITY * TICK_DT, -TERMINAL_VELOCITY);
+
+    glm::vec3 delta = m_velocity * TICK_DT;
+    AABB box = getBounds();
+    glm::vec3 moved = sweep(box, delta);
+
+    bool blockedX = moved.x != delta.x;
+    bool blockedZ = moved.z != delta.z;
+    bool landed = delta.y < 0.0f && moved.y != delta.y;
+
+    // Step-up: if a wall stopped us while walking, retry the move from
+    // STEP_HEIGHT higher and settle back down. Keep whichever went further.
+    if ((blockedX || blockedZ) && (m_onGround || landed)) {
+        AABB stepBox = getBounds();
+        float up = sweep(stepBox, glm::vec3(0.0f, STEP_HEIGHT, 0.0f)).y;
+        glm::vec3 stepMoved = sweep(stepBox, glm::vec3(delta.x, 0.0f, delta.z));
+        float down = sweep(stepBox, glm::vec3(0.0f, -up + std::min(delta.y, 0.0f), 0.0f)).y;
+
+        float flat = moved.x * moved.x + moved.z * moved.z;
+        float stepped = stepMoved.x * stepMoved.x + stepMoved.z * stepMoved.z;
+        if (stepped > flat) {
+            box = stepBox;
+            moved = glm::vec3(stepMoved.x, up + down, stepMoved.z);
+            blockedX = moved.x != delta.x;
+            blockedZ = moved.z != delta.z;
+            landed = true;
+        }
+    }
+
+    if (blockedX) m_velocity.x = 0.0f;
+    if (blockedZ) m_velocity.z = 0.0f;
+    if (moved.y != delta.y) m_velocity.y = 0.0f;
+    m_onGround = landed;
+
+    m_position = glm::vec3((box.min.x + box.max.x) * 0.5f, box.min.y, (box.min.z + box.max.z) * 0.5f);
+}
@@ -0,0 +1,49 @@
+#include "world/Simulation.hpp"
+
+Simulation::Simulation(int seed, int viewDistance, WorldMode mode)
+    : m_world(seed, mode), m_viewDistance(viewDistance) {}
+
+std::size_t Simulation::addPlayer(int x, int z) {
+    // Stand on the highest solid block of the column
+    m_world.getOrCreateChunk(World::toChunkCoord(x, Chunk::WIDTH), World::toChunkCoord(z, Chunk::DEPTH));
+    int y = Chunk::HEIGHT - 1;
+    while (y > 0 && !isSolid(m_world.getBlock(x, y, z))) --y;
+
+    // Blocks are centered on integer coords, so the top face is at y + 0.5
+    m_players.emplace_back(glm::vec3(x, y + 0.5f, z));
+    m_inputs.emplace_back();
+    return m_players.size() - 1;
+}
+
+std::size_t Simulation::addViewer(const glm::vec3& position) {
+    for (std::size_t i = 0; i < m_viewers.size(); ++i) {
+        if (!m_viewerActive[i]) {
+            m_viewers[i] = position;
+            m_viewerActive[i] = true;
+            return i;
+        }
+    }
+    m_viewers.push_back(position);
+    m_viewerActive.push_back(true);
+    return m_viewers.size() - 1;
+}
+
+void Simulation::removeViewer(std::size_t viewer) {
+    m_viewerActive[viewer] = false;
+}
+
+void Simulation::tick() {
+    m_world.tick();
+    for (std::size_t i = 0; i < m_players.size(); ++i) {
+        m_players[i].tick(m_world, m_inputs[i]);
+    }
+
+    m_positions.clear();
+    for (const Player& player : m_players) m_positions.push_back(player.getPosition());
+    for (std::size_t i = 0; i < m_viewers.size(); ++i) {
+        if (m_viewerActive[i]) m_positions.push_back(m_viewers[i]);
+    }
+    m_world.update(m_positions, m_viewDistance);
+
+    ++m_tickCount;
+}
@@ -1,116 +1,456 @@
 #include "world/World.hpp"
+#include "world/ChunkNeighborhood.hpp"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <iterator>
+#include <limits>
 #include <glm/glm.hpp>
 
-World::World(int seed) : m_seed(seed) {
+namespace {
+    using StatsClock = std::chrono::steady_clock;
+
+    double msSince(StatsClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(StatsClock::now() - start).count();
+    }
+}
+
+World::World(int seed, WorldMode mode)
+    : m_seed(seed), m_mode(mode), m_generator(seed) {
+    if (m_mode == WorldMode::REMOTE) return;
+
     // Load initial chunks at origin
+    std::vector<std::pair<int, int>> coords;
     for (int x = -2; x <= 2; ++x) {
         for (int z = -2; z <= 2; ++z) {
-            getOrCreateChunk(x, z);
+            coords.emplace_back(x, z);
         }
     }
+    loadChunks(coords);
 }
 
 std::shared_ptr<Chunk> World::getOrCreateChunk(int chunkX, int chunkZ) {
     int64_t key = encodeChunkKey(chunkX, chunkZ);
     
     auto it = m_chunks.find(key);
-    if (it != m_chunks.end()) {
-        return it->second;
-    }
-
-    // Create new chunk and generate terrain
-    auto chunk = std::make_shared<Chunk>(chunkX, chunkZ);
-    generateTerrain(chunk);
-    chunk->generateMesh();
-
-    m_chunks[key] = chunk;
-    return chunk;
-}
-
-float World::getNoise(float x, float z) const {
-    // Simple noise function based on sine waves and the seed
-    // Could use a proper Perlin noise library
-    float n = std::sin(x * 0.1f + m_seed) * std::cos(z * 0.1f + m_seed);
-    n += std::sin((x + z) * 0.05f) * std::cos((x - z) * 0.05f);
-    return (n + 2.0f) / 4.0f; // Normalize to roughly 0-1
-}
-
-void World::generateTerrain(std::shared_ptr<Chunk> chunk) {
-    int chunkX = chunk->getChunkX();
-    int chunkZ = chunk->getChunkZ();
-
-    for (int lx = 0; lx < Chunk::WIDTH; ++lx) {
-        for (int lz = 0; lz < Chunk::DEPTH; ++lz) {
-            // World coordinates
-            float wx = chunkX * Chunk::WIDTH + lx;
-            float wz = chunkZ * Chunk::DEPTH + lz;
-
-            // Generate height based on noise (wider range for more variety)
-            float noiseVal = getNoise(wx, wz);
-            int maxHeight = 20 + (int)(noiseVal * 60.0f); // Height range: 20-80
-            maxHeight = glm::clamp(maxHeight, 5, Chunk::HEIGHT - 1);
-
-            for (int y = 0; y < maxHeight; ++y) {
-                BlockType blockType;
-
-                // More varied layering based on depth
-                if (y < 5) {
-                    // Deep bedrock-like stone
-                    blockType = BlockType::STONE;
-                } else if (y < maxHeight - 3) {
-                    // Middle stone/dirt
-                    blockType = BlockType::STONE;
-                } else if (y < maxHeight - 1) {
-                    // Dirt layer
-                    blockType = BlockType::DIRT;
-                } else {
-                    // Grass on top
-                    blockType = BlockType::GRASS;
-                }
+    if (it == m_chunks.end()) {
+        if (m_mode == WorldMode::REMOTE) return nullptr;
+        loadChunks({ { chunkX, chunkZ } });
+        it = m_chunks.find(key);
+    }
+    return it->second;
+}
+
+void World::loadChunks(const std::vector<std::pair<int, int>>& coords) {
+    if (coords.empty()) return;
+
+    // Chunks come from the pool on this thread, so the workers never allocate
+    auto start = StatsClock::now();
+    m_created.clear();
+    for (const auto& [x, z] : coords) m_created.push_back(m_pool.acquire(x, z));
+
+    // Terrain: every generator stage only depends on the seed and position,
+    // so all the new chunks can be generated at the same time
+    m_workers.parallelFor(m_created.size(), [this](std::size_t i) {
+        m_generator.generate(*m_created[i]);
+    });
+    m_stats.generateMs += msSince(start);
+    addChunks(m_created);
+    // Only the map holds them now, so they're free again as soon as they unload
+    m_created.clear();
+}
+
+void World::addChunks(const std::vector<std::shared_ptr<Chunk>>& chunks) {
+    if (chunks.empty()) return;
+    m_stats.chunksLoaded += chunks.size();
+
+    // Sky light straight down only touches the chunk itself
+    auto start = StatsClock::now();
+    m_workers.parallelFor(chunks.size(), [&](std::size_t i) {
+        LightEngine::lightColumns(*chunks[i]);
+    });
+
+    for (const auto& chunk : chunks) insertChunk(chunk);
+    ++m_chunkEpoch;
+    for (const auto& chunk : chunks) m_ticks.onChunkLoaded(chunk->getChunkX(), chunk->getChunkZ());
+
+    // Spreading light needs the chunks in the map so it can flow over to the
+    // neighbors. It also writes into them, so it stays on this thread
+    for (const auto& chunk : chunks) {
+        m_lighting.spreadChunk(*chunk);
+    }
+    m_stats.lightMs += msSince(start);
 
-                chunk->setBlock(lx, y, lz, blockType);
+    // Meshing only reads the neighbors, so it can go wide again. The chunks
+    // already loaded around the new ones were meshed without them (faces
+    // toward them kept, AO cut off at the border, corners too), so they go
+    // in the same batch
+    if (m_mode == WorldMode::HEADLESS) return;
+    start = StatsClock::now();
+    m_dirty.clear();
+    for (const auto& chunk : chunks) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (Chunk* c = findChunk(chunk->getChunkX() + dx, chunk->getChunkZ() + dz)) m_dirty.push_back(c);
             }
+        }
+    }
+    std::sort(m_dirty.begin(), m_dirty.end());
+    m_dirty.erase(std::unique(m_dirty.begin(), m_dirty.end()), m_dirty.end());
+    m_workers.parallelFor(m_dirty.size(), [this](std::size_t i) {
+        ChunkNeighborhood neighbors(*this, m_dirty[i]->getChunkX(), m_dirty[i]->getChunkZ());
+        m_dirty[i]->generateMesh(&neighbors, m_meshFormat);
+    });
+    m_stats.meshesBuilt += m_dirty.size();
+    m_stats.meshMs += msSince(start);
+}
+
+bool World::removeChunk(int chunkX, int chunkZ) {
+    auto it = m_chunks.find(encodeChunkKey(chunkX, chunkZ));
+    if (it == m_chunks.end()) return false;
+    eraseChunk(it);
+    ++m_chunkEpoch;
+    m_stats.chunksUnloaded++;
+    return true;
+}
+
+void World::insertChunk(const std::shared_ptr<Chunk>& chunk) {
+    int64_t key = encodeChunkKey(chunk->getChunkX(), chunk->getChunkZ());
+    auto it = m_chunks.find(key);
+    if (it != m_chunks.end()) {
+        it->second = chunk;
+        return;
+    }
+    if (m_freeNodes.empty()) {
+        m_chunks.emplace(key, chunk);
+        return;
+    }
+    ChunkMap::node_type node = std::move(m_freeNodes.back());
+    m_freeNodes.pop_back();
+    node.key() = key;
+    node.mapped() = chunk;
+    m_chunks.insert(std::move(node));
+}
+
+World::ChunkMap::iterator World::eraseChunk(ChunkMap::iterator it) {
+    auto next = std::next(it);
+    ChunkMap::node_type node = m_chunks.extract(it);
+    node.mapped().reset(); // back to the pool, unless someone else still holds it
+    m_freeNodes.push_back(std::move(node));
+    return next;
+}
+
+void World::setMeshFormat(MeshFormat format) {
+    if (format == m_meshFormat) return;
+    m_meshFormat = format;
+    for (auto& [key, chunk] : m_chunks) chunk->markDirty();
+}
+
+Chunk* World::findChunk(int chunkX, int chunkZ) const {
+    auto it = m_chunks.find(encodeChunkKey(chunkX, chunkZ));
+    return it != m_chunks.end() ? it->second.get() : nullptr;
+}
+
+BlockType World::getBlock(int x, int y, int z) const {
+    int chunkX = toChunkCoord(x, Chunk::WIDTH);
+    int chunkZ = toChunkCoord(z, Chunk::DEPTH);
+    const Chunk* chunk = findChunk(chunkX, chunkZ);
+    if (!chunk) return BlockType::AIR;
+    return chunk->getBlock(x - chunkX * Chunk::WIDTH, y, z - chunkZ * Chunk::DEPTH);
+}
+
+bool World::setBlock(int x, int y, int z, BlockType type) {
+    if (y < 0 || y >= Chunk::HEIGHT) return false;
+    int chunkX = toChunkCoord(x, Chunk::WIDTH);
+    int chunkZ = toChunkCoord(z, Chunk::DEPTH);
+    Chunk* chunk = findChunk(chunkX, chunkZ);
+    if (!chunk) return false;
+
+    int lx = x - chunkX * Chunk::WIDTH;
+    int lz = z - chunkZ * Chunk::DEPTH;
+    BlockType old = chunk->getBlock(lx, y, lz);
+    if (old == type) return true;
+    chunk->setBlock(lx, y, lz, type);
+    chunk->markDirty();
+
+    // Neighbor meshes sample blocks across the border (and corners) for AO
+    int x0 = lx == 0 ? -1 : 0, x1 = lx == Chunk::WIDTH - 1 ? 1 : 0;
+    int z0 = lz == 0 ? -1 : 0, z1 = lz == Chunk::DEPTH - 1 ? 1 : 0;
+    for (int dz = z0; dz <= z1; ++dz) {
+        for (int dx = x0; dx <= x1; ++dx) {
+            if (dx == 0 && dz == 0) continue;
+            if (Chunk* neighbor = findChunk(chunkX + dx, chunkZ + dz)) neighbor->markDirty();
+        }
+    }
+
+    // Light only depends on how much a block lets through and gives off,
+    // water changing level doesn't need a relight
+    if (lightOpacity(old) != lightOpacity(type) || lightEmission(old) != lightEmission(type)) {
+        if (m_deferLight) m_deferredLight.emplace_back(x, y, z);
+        else m_lighting.onBlockChanged(x, y, z);
+    }
+    m_ticks.onBlockChanged(x, y, z);
+    return true;
+}
+
+void World::tick() {
+    auto start = StatsClock::now();
 
-            // Fill rest with air
-            for (int y = maxHeight; y < Chunk::HEIGHT; ++y) {
-                chunk->setBlock(lx, y, lz, BlockType::AIR);
+    // Light waits for the end of the tick, so a whole edge of water pouring
+    // over a cliff relights the air under it once, not once per block. One
+    // chunk's relight can flood a whole lake, so only a few chunks go per
+    // tick, the rest (oldest first) carry over to the next ones
+    m_deferLight = true;
+    m_ticks.tick();
+    m_deferLight = false;
+    if (!m_deferredLight.empty()) m_lighting.onBlocksChanged(m_deferredLight, LIGHT_CHUNKS_PER_TICK);
+    m_stats.blockUpdates += m_ticks.getLastUpdates();
+    m_stats.randomTickHits += m_ticks.getLastRandomHits();
+    m_stats.tickChanges += m_ticks.getChanges().size();
+    m_stats.tickMs += msSince(start);
+}
+
+namespace {
+
+// Remembers the last chunk a ray walked through so the map is only
+// searched again when the ray steps over a chunk border
+struct ChunkCursor {
+    int chunkX = std::numeric_limits<int>::min();
+    int chunkZ = std::numeric_limits<int>::min();
+    const Chunk* chunk = nullptr;
+
+    const Chunk* get(const World& world, int cx, int cz) {
+        if (cx != chunkX || cz != chunkZ) {
+            chunkX = cx;
+            chunkZ = cz;
+            chunk = world.findChunk(cx, cz);
+        }
+        return chunk;
+    }
+};
+
+RaycastHit castRay(const World& world, ChunkCursor& cursor,
+                   const glm::vec3& origin, const glm::vec3& direction, float maxDistance) {
+    RaycastHit result;
+
+    float len = glm::length(direction);
+    if (len <= 0.0f || maxDistance <= 0.0f) return result;
+    glm::vec3 dir = direction / len;
+
+    // Blocks are centered on integer coords (block x covers x-0.5 .. x+0.5),
+    // shift by half a block so floor() gives the block we're in
+    glm::vec3 p = origin + glm::vec3(0.5f);
+    glm::ivec3 cell(static_cast<int>(std::floor(p.x)),
+                    static_cast<int>(std::floor(p.y)),
+                    static_cast<int>(std::floor(p.z)));
+
+    const float inf = std::numeric_limits<float>::infinity();
+    glm::ivec3 step(0);
+    glm::vec3 tMax(inf);   // t at which the ray crosses the next cell border on each axis
+    glm::vec3 tDelta(inf); // t it takes to cross one whole cell on each axis
+    for (int axis = 0; axis < 3; ++axis) {
+        if (dir[axis] > 0.0f) {
+            step[axis] = 1;
+            tDelta[axis] = 1.0f / dir[axis];
+            tMax[axis] = (static_cast<float>(cell[axis]) + 1.0f - p[axis]) * tDelta[axis];
+        } else if (dir[axis] < 0.0f) {
+            step[axis] = -1;
+            tDelta[axis] = -1.0f / dir[axis];
+            tMax[axis] = (p[axis] - static_cast<float>(cell[axis])) * tDelta[axis];
+        }
+    }
+
+    // Outward normal -> face, indexed by axis and whether the normal is positive
+    static const BlockFace faces[3][2] = {
+        { BlockFace::NEG_X, BlockFace::POS_X },
+        { BlockFace::NEG_Y, BlockFace::POS_Y },
+        { BlockFace::NEG_Z, BlockFace::POS_Z },
+    };
+
+    float t = 0.0f;
+    int lastAxis = -1;
+    while (t <= maxDistance) {
+        if (cell.y >= 0 && cell.y < Chunk::HEIGHT) {
+            int cx = World::toChunkCoord(cell.x, Chunk::WIDTH);
+            int cz = World::toChunkCoord(cell.z, Chunk::DEPTH);
+            const Chunk* chunk = cursor.get(world, cx, cz);
+            if (chunk) {
+                BlockType type = chunk->getBlock(cell.x - cx * Chunk::WIDTH, cell.y,
+                                                 cell.z - cz * Chunk::DEPTH);
+                if (isSolid(type)) {
+                    result.hit = true;
+                    result.block = cell;
+                    result.type = type;
+                    result.distance = t;
+                    if (lastAxis >= 0) {
+                        result.normal[lastAxis] = -step[lastAxis];
+                        result.face = faces[lastAxis][step[lastAxis] < 0 ? 1 : 0];
+                    }
+                    return result;
+                }
             }
+        } else if ((cell.y < 0 && step.y <= 0) || (cell.y >= Chunk::HEIGHT && step.y >= 0)) {
+            // Left the world vertically and never coming back
+            break;
         }
+
+        // Step into the next cell along whichever axis border is closest
+        if (tMax.x < tMax.y) {
+            lastAxis = tMax.x < tMax.z ? 0 : 2;
+        } else {
+            lastAxis = tMax.y < tMax.z ? 1 : 2;
+        }
+        t = tMax[lastAxis];
+        tMax[lastAxis] += tDelta[lastAxis];
+        cell[lastAxis] += step[lastAxis];
+    }
+
+    return result;
+}
+
+} // namespace
+
+RaycastHit World::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const {
+    ChunkCursor cursor;
+    return castRay(*this, cursor, origin, direction, maxDistance);
+}
+
+void World::raycastBatch(const Ray* rays, std::size_t count, RaycastHit* hits) const {
+    ChunkCursor cursor;
+    for (std::size_t i = 0; i < count; ++i) {
+        hits[i] = castRay(*this, cursor, rays[i].origin, rays[i].direction, rays[i].maxDistance);
     }
 }
 
+bool World::waitingForLight(int chunkX, int chunkZ) const {
+    if (m_waitingForLight.empty()) return false;
+    // Sorted by x then z, so each column of the 3x3 is one range
+    for (int x = chunkX - 1; x <= chunkX + 1; ++x) {
+        auto it = std::lower_bound(m_waitingForLight.begin(), m_waitingForLight.end(), std::make_pair(x, chunkZ - 1));
+        if (it != m_waitingForLight.end() && it->first == x && it->second <= chunkZ + 1) return true;
+    }
+    return false;
+}
+
+void World::rebuildDirtyMeshes() {
+    if (m_mode == WorldMode::HEADLESS) return;
+
+    // Chunks still waiting for light, or next to one that is (it'll spread
+    // into them), keep their old mesh until it's all there: no dark frames,
+    // and one remesh each instead of one per neighbor. That's what bulk edits
+    // left in the relight queue, and block changes ticks had no room to relight
+    m_waitingForLight.assign(m_relightQueue.begin(), m_relightQueue.end());
+    for (const glm::ivec3& b : m_deferredLight) {
+        m_waitingForLight.emplace_back(toChunkCoord(b.x, Chunk::WIDTH), toChunkCoord(b.z, Chunk::DEPTH));
+    }
+    std::sort(m_waitingForLight.begin(), m_waitingForLight.end());
+    m_waitingForLight.erase(std::unique(m_waitingForLight.begin(), m_waitingForLight.end()), m_waitingForLight.end());
+
+    m_dirty.clear();
+    for (auto& [key, chunk] : m_chunks) {
+        if (!chunk->isDirty() || waitingForLight(chunk->getChunkX(), chunk->getChunkZ())) continue;
+        m_dirty.push_back(chunk.get());
+    }
+    if (m_dirty.empty()) return;
+
+    auto start = StatsClock::now();
+    m_workers.parallelFor(m_dirty.size(), [this](std::size_t i) {
+        ChunkNeighborhood neighbors(*this, m_dirty[i]->getChunkX(), m_dirty[i]->getChunkZ());
+        m_dirty[i]->generateMesh(&neighbors, m_meshFormat);
+    });
+    m_stats.meshesBuilt += m_dirty.size();
+    m_stats.meshMs += msSince(start);
+}
+
 void World::update(const glm::vec3& cameraPos, int renderDistance) {
-    // Determine which chunk the camera is in
-    int cameraChunkX = (int)std::floor(cameraPos.x / Chunk::WIDTH);
-    int cameraChunkZ = (int)std::floor(cameraPos.z / Chunk::DEPTH);
+    updateViewers(&cameraPos, 1, renderDistance);
+}
+
+void World::update(const std::vector<glm::vec3>& viewers, int renderDistance) {
+    updateViewers(viewers.data(), viewers.size(), renderDistance);
+}
+
+void World::updateViewers(const glm::vec3* viewers, std::size_t count, int renderDistance) {
+    // Pick up block edits made since the last frame
+    drainRelights();
+    rebuildDirtyMeshes();
+    if (m_mode == WorldMode::REMOTE) return;
+
+    // Determine which chunk each viewer is in
+    m_nextViewerChunks.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        m_nextViewerChunks.emplace_back((int)std::floor(viewers[i].x / Chunk::WIDTH),
+                                        (int)std::floor(viewers[i].z / Chunk::DEPTH));
+    }
+    std::sort(m_nextViewerChunks.begin(), m_nextViewerChunks.end());
+    m_nextViewerChunks.erase(std::unique(m_nextViewerChunks.begin(), m_nextViewerChunks.end()),
+                             m_nextViewerChunks.end());
 
-    // Only update if camera moved to a different chunk
-    if (cameraChunkX == m_centerChunkX && cameraChunkZ == m_centerChunkZ) {
+    // Only update if some viewer moved to a different chunk, the distance
+    // changed, or the last update left chunks to load
+    if (m_nextViewerChunks == m_viewerChunks && renderDistance == m_renderDistance && m_pendingLoads == 0) {
         return;
     }
+    std::swap(m_viewerChunks, m_nextViewerChunks);
+    m_renderDistance = renderDistance;
 
-    m_centerChunkX = cameraChunkX;
-    m_centerChunkZ = cameraChunkZ;
+    unloadChunks(m_viewerChunks, renderDistance + 1);
 
-    // Load chunks around the camera
-    for (int x = cameraChunkX - renderDistance; x <= cameraChunkX + renderDistance; ++x) {
-        for (int z = cameraChunkZ - renderDistance; z <= cameraChunkZ + renderDistance; ++z) {
-            getOrCreateChunk(x, z);
+    // Load chunks around the viewers, all missing ones in one batch
+    // (viewers close together share most of their squares, so dedupe them)
+    m_missing.clear();
+    for (const auto& [cx, cz] : m_viewerChunks) {
+        for (int x = cx - renderDistance; x <= cx + renderDistance; ++x) {
+            for (int z = cz - renderDistance; z <= cz + renderDistance; ++z) {
+                if (!findChunk(x, z)) m_missing.emplace_back(x, z);
+            }
         }
     }
+    std::sort(m_missing.begin(), m_missing.end());
+    m_missing.erase(std::unique(m_missing.begin(), m_missing.end()), m_missing.end());
 
-    // TODO: Unload distant chunks
-    // For now, we'll keep all loaded chunks.
+    // Over the limit: the chunks nearest to a viewer now, the rest on later updates
+    m_pendingLoads = 0;
+    if (m_loadLimit > 0 && m_missing.size() > m_loadLimit) {
+        auto distance = [this](const std::pair<int, int>& c) {
+            int best = std::numeric_limits<int>::max();
+            for (const auto& [vx, vz] : m_viewerChunks) {
+                best = std::min(best, (c.first - vx) * (c.first - vx) + (c.second - vz) * (c.second - vz));
+            }
+            return best;
+        };
+        std::partial_sort(m_missing.begin(), m_missing.begin() + m_loadLimit, m_missing.end(),
+                          [&](const auto& a, const auto& b) { return distance(a) < distance(b); });
+        m_pendingLoads = m_missing.size() - m_loadLimit;
+        m_missing.resize(m_loadLimit);
+    }
+    loadChunks(m_missing);
 }
 
-void World::render(unsigned int shaderProgram) const {
-    glm::mat4 identity = glm::mat4(1.0f);
-    
-    for (const auto& [key, chunk] : m_chunks) {
-        if (chunk && chunk->hasMesh()) {
-            chunk->render(shaderProgram, identity);
+void World::unloadChunks(const std::vector<std::pair<int, int>>& viewerChunks, int keepDistance) {
+    // Every chunk some viewer wants kept (sorted, for binary searches),
+    // cheaper than checking each chunk against each viewer once there are
+    // hundreds of them
+    m_keep.clear();
+    for (const auto& [cx, cz] : viewerChunks) {
+        for (int x = cx - keepDistance; x <= cx + keepDistance; ++x) {
+            for (int z = cz - keepDistance; z <= cz + keepDistance; ++z) {
+                m_keep.push_back(encodeChunkKey(x, z));
+            }
+        }
+    }
+    std::sort(m_keep.begin(), m_keep.end());
+
+    bool unloaded = false;
+    for (auto it = m_chunks.begin(); it != m_chunks.end();) {
+        if (std::binary_search(m_keep.begin(), m_keep.end(), it->first)) {
+            ++it;
+        } else {
+            it = eraseChunk(it);
+            unloaded = true;
+            m_stats.chunksUnloaded++;
         }
     }
+    if (unloaded) ++m_chunkEpoch;
 }
@@ -0,0 +1,252 @@
+// World's bulk edits (fill, replace, sphere, copy/paste), see World.hpp
+
+#include "world/World.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    using StatsClock = std::chrono::steady_clock;
+
+    double msSince(StatsClock::time_point start) {
+        return std::chrono::duration<double, std::milli>(StatsClock::now() - start).count();
+    }
+
+    // Row (y, z) of a chunk's blocks, x = 0..15
+    BlockType* chunkRow(Chunk& chunk, int y, int z) {
+        return chunk.getSectionBlocks(y / Chunk::SECTION_HEIGHT) +
+               ((y % Chunk::SECTION_HEIGHT) * Chunk::DEPTH + z) * Chunk::WIDTH;
+    }
+    const BlockType* chunkRow(const Chunk& chunk, int y, int z) {
+        return chunk.getSectionBlocks(y / Chunk::SECTION_HEIGHT) +
+               ((y % Chunk::SECTION_HEIGHT) * Chunk::DEPTH + z) * Chunk::WIDTH;
+    }
+
+    // Overwrite a run of blocks, counting the ones that actually change
+    // (branch-free so the compiler can vectorize it)
+    uint64_t fillRun(BlockType* run, int count, BlockType type) {
+        uint64_t changed = 0;
+        for (int i = 0; i < count; ++i) {
+            changed += run[i] != type;
+            run[i] = type;
+        }
+        return changed;
+    }
+}
+
+void World::splitBox(const BlockBox& box, std::vector<BoxPiece>& pieces) const {
+    pieces.clear();
+    int minY = std::max(box.min.y, 0);
+    int maxY = std::min(box.max.y, Chunk::HEIGHT - 1);
+    if (box.empty() || minY > maxY) return;
+
+    int cx0 = toChunkCoord(box.min.x, Chunk::WIDTH), cx1 = toChunkCoord(box.max.x, Chunk::WIDTH);
+    int cz0 = toChunkCoord(box.min.z, Chunk::DEPTH), cz1 = toChunkCoord(box.max.z, Chunk::DEPTH);
+    for (int cz = cz0; cz <= cz1; ++cz) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            Chunk* chunk = findChunk(cx, cz);
+            if (!chunk) continue;
+
+            int ox = cx * Chunk::WIDTH, oz = cz * Chunk::DEPTH;
+            BlockBox local;
+            local.min.x = std::max(box.min.x - ox, 0);
+            local.max.x = std::min(box.max.x - ox, Chunk::WIDTH - 1);
+            local.min.z = std::max(box.min.z - oz, 0);
+            local.max.z = std::min(box.max.z - oz, Chunk::DEPTH - 1);
+            for (int s = minY / Chunk::SECTION_HEIGHT; s <= maxY / Chunk::SECTION_HEIGHT; ++s) {
+                local.min.y = std::max(minY, s * Chunk::SECTION_HEIGHT);
+                local.max.y = std::min(maxY, s * Chunk::SECTION_HEIGHT + Chunk::SECTION_HEIGHT - 1);
+                pieces.push_back({ chunk, local });
+            }
+        }
+    }
+}
+
+EditStats World::editBox(const BlockBox& box, const SectionEdit& edit) {
+    EditStats stats;
+    auto start = StatsClock::now();
+
+    // Pieces never share a section, so they can all be written at once
+    std::vector<BoxPiece> pieces;
+    splitBox(box, pieces);
+    std::vector<uint64_t> changed(pieces.size());
+    m_workers.parallelFor(pieces.size(), [&](std::size_t i) {
+        changed[i] = edit(*pieces[i].chunk, pieces[i].local);
+    });
+
+    std::vector<Chunk*> changedChunks;
+    for (std::size_t i = 0; i < pieces.size(); ++i) {
+        if (!changed[i]) continue;
+        stats.blocksChanged += changed[i];
+        if (changedChunks.empty() || changedChunks.back() != pieces[i].chunk) {
+            changedChunks.push_back(pieces[i].chunk);
+        }
+    }
+    stats.chunksChanged = changedChunks.size();
+    stats.editMs = msSince(start);
+    if (changedChunks.empty()) return stats;
+
+    start = StatsClock::now();
+    stats.chunksRelit = relightChunks(changedChunks);
+    stats.lightMs = msSince(start);
+    m_ticks.onBoxChanged(box);
+    return stats;
+}
+
+std::size_t World::relightChunks(const std::vector<Chunk*>& changed) {
+    std::vector<std::pair<int, int>> coords;
+    for (const Chunk* chunk : changed) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                coords.emplace_back(chunk->getChunkX() + dx, chunk->getChunkZ() + dz);
+            }
+        }
+    }
+    std::sort(coords.begin(), coords.end());
+    coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+
+    std::vector<Chunk*> relit;
+    for (const auto& [x, z] : coords) {
+        if (Chunk* chunk = findChunk(x, z)) {
+            relit.push_back(chunk);
+            m_relightQueue.emplace_back(x, z);
+        }
+    }
+
+    // Same order as loading a batch: every column first, then the spreading
+    // (which reads and writes the neighbors). All of the old light goes right
+    // away, so none of it can flow back in from a chunk still waiting. The
+    // spreading is most of the cost, it's left to update() (see drainRelights())
+    m_workers.parallelFor(relit.size(), [&](std::size_t i) {
+        relit[i]->clearLight();
+        LightEngine::lightColumns(*relit[i]);
+    });
+    std::sort(m_relightQueue.begin(), m_relightQueue.end());
+    m_relightQueue.erase(std::unique(m_relightQueue.begin(), m_relightQueue.end()), m_relightQueue.end());
+    return relit.size();
+}
+
+void World::drainRelights() {
+    if (m_relightQueue.empty()) return;
+    auto start = StatsClock::now();
+
+    // Spreading only ever adds light, so the chunks can go in any order and
+    // over any number of updates and still end up where one batch would
+    std::size_t count = m_relightLimit > 0 ? std::min(m_relightQueue.size(), m_relightLimit) : m_relightQueue.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        Chunk* chunk = findChunk(m_relightQueue[i].first, m_relightQueue[i].second);
+        if (!chunk) continue; // unloaded since, it gets lit from scratch if it comes back
+        m_lighting.spreadChunk(*chunk);
+        chunk->markDirty();
+    }
+    m_relightQueue.erase(m_relightQueue.begin(), m_relightQueue.begin() + count);
+    m_stats.lightMs += msSince(start);
+}
+
+EditStats World::fillBox(const BlockBox& box, BlockType type) {
+    return editBox(box, [type](Chunk& chunk, const BlockBox& local) {
+        uint64_t changed = 0;
+        int count = local.max.x - local.min.x + 1;
+        for (int y = local.min.y; y <= local.max.y; ++y) {
+            for (int z = local.min.z; z <= local.max.z; ++z) {
+                changed += fillRun(chunkRow(chunk, y, z) + local.min.x, count, type);
+            }
+        }
+        return changed;
+    });
+}
+
+EditStats World::replaceInBox(const BlockBox& box, BlockType from, BlockType to) {
+    if (from == to) return EditStats{};
+    return editBox(box, [from, to](Chunk& chunk, const BlockBox& local) {
+        uint64_t changed = 0;
+        for (int y = local.min.y; y <= local.max.y; ++y) {
+            for (int z = local.min.z; z <= local.max.z; ++z) {
+                BlockType* row = chunkRow(chunk, y, z);
+                for (int x = local.min.x; x <= local.max.x; ++x) {
+                    bool match = row[x] == from;
+                    changed += match;
+                    row[x] = match ? to : row[x];
+                }
+            }
+        }
+        return changed;
+    });
+}
+
+EditStats World::fillSphere(const glm::ivec3& center, int radius, BlockType type) {
+    if (radius < 0) return EditStats{};
+    BlockBox box(center - glm::ivec3(radius), center + glm::ivec3(radius));
+    int64_t radius2 = static_cast<int64_t>(radius) * radius;
+
+    return editBox(box, [=](Chunk& chunk, const BlockBox& local) {
+        int ox = chunk.getChunkX() * Chunk::WIDTH;
+        int oz = chunk.getChunkZ() * Chunk::DEPTH;
+        uint64_t changed = 0;
+        for (int y = local.min.y; y <= local.max.y; ++y) {
+            int64_t dy = y - center.y;
+            for (int z = local.min.z; z <= local.max.z; ++z) {
+                int64_t dz = oz + z - center.z;
+                int64_t left = radius2 - dy * dy - dz * dz;
+                if (left < 0) continue;
+
+                // Each row of a sphere is one run, half as wide as sqrt(left)
+                int64_t half = static_cast<int64_t>(std::sqrt(static_cast<double>(left)));
+                while (half * half > left) --half;
+                while ((half + 1) * (half + 1) <= left) ++half;
+                int x0 = std::max<int64_t>(local.min.x, center.x - half - ox);
+                int x1 = std::min<int64_t>(local.max.x, center.x + half - ox);
+                if (x0 > x1) continue;
+                changed += fillRun(chunkRow(chunk, y, z) + x0, x1 - x0 + 1, type);
+            }
+        }
+        return changed;
+    });
+}
+
+Clipboard World::copyBox(const BlockBox& box) const {
+    if (box.empty()) return Clipboard();
+    Clipboard clipboard(box.size());
+
+    std::vector<BoxPiece> pieces;
+    splitBox(box, pieces);
+    m_workers.parallelFor(pieces.size(), [&](std::size_t i) {
+        const Chunk& chunk = *pieces[i].chunk;
+        const BlockBox& local = pieces[i].local;
+        int ox = chunk.getChunkX() * Chunk::WIDTH;
+        int oz = chunk.getChunkZ() * Chunk::DEPTH;
+        int count = local.max.x - local.min.x + 1;
+        for (int y = local.min.y; y <= local.max.y; ++y) {
+            for (int z = local.min.z; z <= local.max.z; ++z) {
+                BlockType* dst = clipboard.row(y - box.min.y, oz + z - box.min.z) + (ox + local.min.x - box.min.x);
+                std::memcpy(dst, chunkRow(chunk, y, z) + local.min.x, count * sizeof(BlockType));
+            }
+        }
+    });
+    return clipboard;
+}
+
+EditStats World::paste(const Clipboard& clipboard, const glm::ivec3& origin, bool skipAir) {
+    if (clipboard.empty()) return EditStats{};
+    BlockBox box(origin, origin + clipboard.getSize() - glm::ivec3(1));
+
+    return editBox(box, [&](Chunk& chunk, const BlockBox& local) {
+        int ox = chunk.getChunkX() * Chunk::WIDTH;
+        int oz = chunk.getChunkZ() * Chunk::DEPTH;
+        int count = local.max.x - local.min.x + 1;
+        uint64_t changed = 0;
+        for (int y = local.min.y; y <= local.max.y; ++y) {
+            for (int z = local.min.z; z <= local.max.z; ++z) {
+                const BlockType* src = clipboard.row(y - origin.y, oz + z - origin.z) + (ox + local.min.x - origin.x);
+                BlockType* dst = chunkRow(chunk, y, z) + local.min.x;
+                for (int x = 0; x < count; ++x) {
+                    BlockType type = skipAir && src[x] == BlockType::AIR ? dst[x] : src[x];
+                    changed += dst[x] != type;
+                    dst[x] = type;
+                }
+            }
+        }
+        return changed;
+    });
+}
@@ -0,0 +1,275 @@
+#include "world/WorldGenerator.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Salts so each use of the hash gets its own random stream
+    constexpr uint32_t SALT_CAVE_A = 1;
+    constexpr uint32_t SALT_CAVE_B = 2;
+    constexpr uint32_t SALT_TREES = 3;
+
+    // Caves are sampled on a coarse grid and interpolated in between
+    constexpr int CAVE_STEP = 4;
+    constexpr int CAVE_GRID_XZ = Chunk::WIDTH / CAVE_STEP + 1;
+    constexpr int CAVE_GRID_Y = Chunk::HEIGHT / CAVE_STEP + 1;
+    constexpr int CAVE_MIN_Y = 4;     // keep a solid floor at the bottom of the world
+    constexpr int CAVE_CRUST = 5;     // blocks of solid ground kept under the surface
+
+    inline float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+}
+
+WorldGenerator::WorldGenerator(int seed) : m_seed(seed) {}
+
+uint32_t WorldGenerator::hash(int x, int y, int z, uint32_t salt) const {
+    uint32_t h = static_cast<uint32_t>(m_seed) * 0x9E3779B1u ^ salt * 0x85EBCA77u;
+    h ^= static_cast<uint32_t>(x) * 0x27D4EB2Du;
+    h = (h ^ (h >> 15)) * 0x2C1B3C6Du;
+    h ^= static_cast<uint32_t>(y) * 0x165667B1u;
+    h = (h ^ (h >> 12)) * 0x297A2D39u;
+    h ^= static_cast<uint32_t>(z) * 0xD3A2646Cu;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+float WorldGenerator::getNoise(float x, float z) const {
+    // Simple noise function based on sine waves and the seed
+    // Could use a proper Perlin noise library
+    float n = std::sin(x * 0.1f + m_seed) * std::cos(z * 0.1f + m_seed);
+    n += std::sin((x + z) * 0.05f) * std::cos((x - z) * 0.05f);
+    return (n + 2.0f) / 4.0f; // Normalize to roughly 0-1
+}
+
+float WorldGenerator::gradientNoise(float x, float y, float z, uint32_t salt) const {
+    // Classic Perlin noise with the 12 cube-edge gradients picked by hash
+    static const float grads[12][3] = {
+        { 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+        { 1, 0, 1 }, { -1, 0, 1 }, { 1, 0, -1 }, { -1, 0, -1 },
+        { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 },
+    };
+
+    int x0 = static_cast<int>(std::floor(x));
+    int y0 = static_cast<int>(std::floor(y));
+    int z0 = static_cast<int>(std::floor(z));
+    float fx = x - x0, fy = y - y0, fz = z - z0;
+
+    float corners[8];
+    for (int i = 0; i < 8; ++i) {
+        int dx = i & 1, dy = (i >> 1) & 1, dz = (i >> 2) & 1;
+        const float* g = grads[hash(x0 + dx, y0 + dy, z0 + dz, salt) % 12];
+        corners[i] = g[0] * (fx - dx) + g[1] * (fy - dy) + g[2] * (fz - dz);
+    }
+
+    float u = fade(fx), v = fade(fy), w = fade(fz);
+    float x00 = glm::mix(corners[0], corners[1], u);
+    float x10 = glm::mix(corners[2], corners[3], u);
+    float x01 = glm::mix(corners[4], corners[5], u);
+    float x11 = glm::mix(corners[6], corners[7], u);
+    return glm::mix(glm::mix(x00, x10, v), glm::mix(x01, x11, v), w);
+}
+
+float WorldGenerator::caveDensity(float x, float y, float z) const {
+    // "Spaghetti" caves: tunnels run where two independent noise fields
+    // are both close to zero
+    float a = gradientNoise(x * 0.03f, y * 0.06f, z * 0.03f, SALT_CAVE_A);
+    float b = gradientNoise(x * 0.03f, y * 0.06f, z * 0.03f, SALT_CAVE_B);
+    return a * a + b * b - 0.008f;
+}
+
+int WorldGenerator::getSurfaceHeight(int x, int z) const {
+    // Generate height based on noise (wider range for more variety)
+    float noiseVal = getNoise(static_cast<float>(x), static_cast<float>(z));
+    int maxHeight = 20 + (int)(noiseVal * 60.0f); // Height range: 20-80
+    maxHeight = glm::clamp(maxHeight, 5, Chunk::HEIGHT - 1);
+    return maxHeight - 1;
+}
+
+void WorldGenerator::generate(Chunk& chunk) const {
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        runStage(static_cast<Stage>(stage), chunk);
+    }
+}
+
+void WorldGenerator::runStage(Stage stage, Chunk& chunk) const {
+    switch (stage) {
+        case BASE:     generateBase(chunk); break;
+        case CARVE:    carveCaves(chunk); break;
+        case SURFACE:  decorateSurface(chunk); break;
+        case FEATURES: placeFeatures(chunk); break;
+        default: break;
+    }
+}
+
+void WorldGenerator::generateBase(Chunk& chunk) const {
+    int chunkX = chunk.getChunkX();
+    int chunkZ = chunk.getChunkZ();
+
+    for (int lx = 0; lx < Chunk::WIDTH; ++lx) {
+        for (int lz = 0; lz < Chunk::DEPTH; ++lz) {
+            int maxHeight = getSurfaceHeight(chunkX * Chunk::WIDTH + lx, chunkZ * Chunk::DEPTH + lz) + 1;
+
+            for (int y = 0; y < maxHeight; ++y) {
+                BlockType blockType;
+
+                // More varied layering based on depth
+                if (y < maxHeight - 3) {
+                    // Deep stone
+                    blockType = BlockType::STONE;
+                } else if (y < maxHeight - 1) {
+                    // Dirt layer
+                    blockType = BlockType::DIRT;
+                } else {
+                    // Grass on top
+                    blockType = BlockType::GRASS;
+                }
+
+                chunk.setBlock(lx, y, lz, blockType);
+            }
+            // Everything above stays AIR from the chunk's constructor
+        }
+    }
+}
+
+void WorldGenerator::carveCaves(Chunk& chunk) const {
+    int baseX = chunk.getChunkX() * Chunk::WIDTH;
+    int baseZ = chunk.getChunkZ() * Chunk::DEPTH;
+
+    int surface[Chunk::DEPTH][Chunk::WIDTH];
+    int highest = 0;
+    for (int lz = 0; lz < Chunk::DEPTH; ++lz) {
+        for (int lx = 0; lx < Chunk::WIDTH; ++lx) {
+            surface[lz][lx] = getSurfaceHeight(baseX + lx, baseZ + lz);
+            highest = std::max(highest, surface[lz][lx]);
+        }
+    }
+    int topCell = std::min((highest - CAVE_CRUST) / CAVE_STEP + 1, CAVE_GRID_Y - 1);
+    if (topCell <= 0) return;
+
+    // Density on the coarse grid, only as high as caves can reach
+    float grid[CAVE_GRID_Y][CAVE_GRID_XZ][CAVE_GRID_XZ];
+    for (int gy = 0; gy <= topCell; ++gy) {
+        for (int gz = 0; gz < CAVE_GRID_XZ; ++gz) {
+            for (int gx = 0; gx < CAVE_GRID_XZ; ++gx) {
+                grid[gy][gz][gx] = caveDensity(static_cast<float>(baseX + gx * CAVE_STEP),
+                                               static_cast<float>(gy * CAVE_STEP),
+                                               static_cast<float>(baseZ + gz * CAVE_STEP));
+            }
+        }
+    }
+
+    const float inv = 1.0f / CAVE_STEP;
+    for (int lz = 0; lz < Chunk::DEPTH; ++lz) {
+        int gz = lz / CAVE_STEP;
+        float tz = (lz % CAVE_STEP) * inv;
+        for (int lx = 0; lx < Chunk::WIDTH; ++lx) {
+            int gx = lx / CAVE_STEP;
+            float tx = (lx % CAVE_STEP) * inv;
+            int top = surface[lz][lx] - CAVE_CRUST;
+            for (int y = CAVE_MIN_Y; y <= top; ++y) {
+                int gy = y / CAVE_STEP;
+                float ty = (y % CAVE_STEP) * inv;
+
+                float d00 = glm::mix(grid[gy][gz][gx], grid[gy][gz][gx + 1], tx);
+                float d10 = glm::mix(grid[gy][gz + 1][gx], grid[gy][gz + 1][gx + 1], tx);
+                float d01 = glm::mix(grid[gy + 1][gz][gx], grid[gy + 1][gz][gx + 1], tx);
+                float d11 = glm::mix(grid[gy + 1][gz + 1][gx], grid[gy + 1][gz + 1][gx + 1], tx);
+                float density = glm::mix(glm::mix(d00, d10, tz), glm::mix(d01, d11, tz), ty);
+
+                if (density < 0.0f) {
+                    chunk.setBlock(lx, y, lz, BlockType::AIR);
+                }
+            }
+        }
+    }
+}
+
+void WorldGenerator::decorateSurface(Chunk& chunk) const {
+    int baseX = chunk.getChunkX() * Chunk::WIDTH;
+    int baseZ = chunk.getChunkZ() * Chunk::DEPTH;
+
+    for (int lz = 0; lz < Chunk::DEPTH; ++lz) {
+        for (int lx = 0; lx < Chunk::WIDTH; ++lx) {
+            int top = getSurfaceHeight(baseX + lx, baseZ + lz);
+
+            // Beaches and sea floor: sand instead of grass/dirt near and under the water line
+            if (top <= SEA_LEVEL + 1) {
+                for (int y = std::max(top - 2, 0); y <= top; ++y) {
+                    chunk.setBlock(lx, y, lz, BlockType::SAND);
+                }
+            }
+
+            // Flood everything below sea level
+            for (int y = top + 1; y <= SEA_LEVEL; ++y) {
+                chunk.setBlock(lx, y, lz, BlockType::WATER);
+            }
+        }
+    }
+}
+
+int WorldGenerator::findTrees(int chunkX, int chunkZ, Tree* out) const {
+    int count = 0;
+    int attempts = hash(chunkX, 0, chunkZ, SALT_TREES) % (MAX_TREES_PER_CHUNK + 1);
+    for (int i = 0; i < attempts; ++i) {
+        uint32_t r = hash(chunkX, i + 1, chunkZ, SALT_TREES);
+        int x = chunkX * Chunk::WIDTH + static_cast<int>(r & 15);
+        int z = chunkZ * Chunk::DEPTH + static_cast<int>((r >> 4) & 15);
+        int top = getSurfaceHeight(x, z);
+
+        // Only on grass - not on beaches or under water
+        if (top <= SEA_LEVEL + 1 || top + 8 >= Chunk::HEIGHT) continue;
+
+        out[count++] = { x, top + 1, z, 4 + static_cast<int>((r >> 8) % 3) };
+    }
+    return count;
+}
+
+void WorldGenerator::placeFeatures(Chunk& chunk) const {
+    const int radius = NEIGHBOR_RADIUS[FEATURES];
+    int baseX = chunk.getChunkX() * Chunk::WIDTH;
+    int baseZ = chunk.getChunkZ() * Chunk::DEPTH;
+
+    // Trees rooted in this chunk and its neighbors, in a fixed order so
+    // overlapping trees resolve the same way no matter who generates first
+    Tree trees[(2 * radius + 1) * (2 * radius + 1) * MAX_TREES_PER_CHUNK];
+    int treeCount = 0;
+    for (int dz = -radius; dz <= radius; ++dz) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            treeCount += findTrees(chunk.getChunkX() + dx, chunk.getChunkZ() + dz, trees + treeCount);
+        }
+    }
+
+    // Writes that land outside this chunk belong to the neighbor, which
+    // places its own share of the same tree
+    auto place = [&](int x, int y, int z, BlockType type, bool onlyAir) {
+        int lx = x - baseX, lz = z - baseZ;
+        if (lx < 0 || lx >= Chunk::WIDTH || lz < 0 || lz >= Chunk::DEPTH) return;
+        if (onlyAir && chunk.getBlock(lx, y, lz) != BlockType::AIR) return;
+        chunk.setBlock(lx, y, lz, type);
+    };
+
+    // Leaves first, then trunks, so a trunk always wins over a neighbor's leaves
+    for (int i = 0; i < treeCount; ++i) {
+        const Tree& t = trees[i];
+        int topY = t.y + t.height - 1;
+        for (int y = topY - 2; y <= topY + 1; ++y) {
+            int r = y <= topY - 1 ? 2 : 1;
+            for (int dz = -r; dz <= r; ++dz) {
+                for (int dx = -r; dx <= r; ++dx) {
+                    // Round off the corners of the top layers
+                    if (y > topY - 1 && dx != 0 && dz != 0 && (dx == r || dx == -r) && (dz == r || dz == -r)) continue;
+                    place(t.x + dx, y, t.z + dz, BlockType::LEAVES, true);
+                }
+            }
+        }
+    }
+    for (int i = 0; i < treeCount; ++i) {
+        const Tree& t = trees[i];
+        for (int y = t.y; y < t.y + t.height; ++y) {
+            place(t.x, y, t.z, BlockType::WOOD, false);
+        }
+    }
+}
@@ -0,0 +1,128 @@
+// Region edit benchmark - big fills, replaces, spheres and copy/pastes on a
+// loaded world, timed the way a frame would see them: the edit call itself
+// (writing the blocks, clearing the light), then the World::update()s that
+// spread the light and remesh, worst one included. For scale, the
+// same kind of box is also filled one World::setBlock() at a time.
+// CPU only, no window or GL context needed.
+//
+// usage: edit_bench [renderDistance] [size]
+//
+// size is the edge of the fill box in blocks (height is capped by the world),
+// the other edits scale with it
+
+#include "world/World.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <utility>
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+double msSince(clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+}
+
+// Run one edit, then the update()s that spread its light and remesh what it
+// touched. setBlockLoop: the edit relit as it went, editMs is write and light
+void report(const char* name, World& world, const glm::vec3& viewer, int renderDistance,
+            const std::function<EditStats()>& edit, bool setBlockLoop = false) {
+    auto start = clock::now();
+    EditStats stats = edit();
+    double editMs = msSince(start);
+
+    WorldStats before = world.getStats();
+    int updates = 0;
+    double worstUpdateMs = 0.0;
+    do {
+        auto updateStart = clock::now();
+        world.update(viewer, renderDistance);
+        worstUpdateMs = std::max(worstUpdateMs, msSince(updateStart));
+        ++updates;
+    } while (world.getPendingRelights() > 0);
+    const WorldStats& after = world.getStats();
+    double lightMs = after.lightMs - before.lightMs;
+    double meshMs = after.meshMs - before.meshMs;
+
+    double total = editMs + lightMs + meshMs;
+    std::cout << name << ": " << stats.blocksChanged << " blocks in " << stats.chunksChanged << " chunks\n";
+    if (setBlockLoop) {
+        std::cout << "  write and light " << stats.editMs << " ms";
+    } else {
+        std::cout << "  write " << stats.editMs << " ms, light " << stats.lightMs << " ms now + " << lightMs
+                  << " ms spread (" << stats.chunksRelit << " chunks)";
+    }
+    std::cout << ", remesh " << meshMs << " ms (" << after.meshesBuilt - before.meshesBuilt << " chunks)\n"
+              << "  edit call " << editMs << " ms, then " << updates << " updates, worst " << worstUpdateMs
+              << " ms\n"
+              << "  total " << total << " ms, " << (total > 0.0 ? stats.blocksChanged / total / 1000.0 : 0.0)
+              << " M blocks/s\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int renderDistance = argc > 1 ? std::atoi(argv[1]) : 8;
+    int size = argc > 2 ? std::atoi(argv[2]) : 128;
+
+    World world(42);
+    glm::vec3 viewer(8.0f, 80.0f, 8.0f);
+    world.update(viewer, renderDistance);
+    std::cout << world.getChunkCount() << " chunks loaded, distance " << renderDistance << "\n";
+
+    int half = size / 2;
+    int height = std::min(size, Chunk::HEIGHT);
+    BlockBox box(glm::ivec3(-half, 0, -half), glm::ivec3(size - half - 1, height - 1, size - half - 1));
+
+    report("fill stone", world, viewer, renderDistance, [&] {
+        return world.fillBox(box, BlockType::STONE);
+    });
+    report("replace stone -> glowstone", world, viewer, renderDistance, [&] {
+        return world.replaceInBox(box, BlockType::STONE, BlockType::GLOWSTONE);
+    });
+    report("sphere of air", world, viewer, renderDistance, [&] {
+        return world.fillSphere(glm::ivec3(0, height / 2, 0), half, BlockType::AIR);
+    });
+
+    Clipboard clipboard;
+    BlockBox source(glm::ivec3(-half, 0, -half), glm::ivec3(-1, height / 2 - 1, -1));
+    auto copyStart = clock::now();
+    clipboard = world.copyBox(source);
+    std::cout << "copy " << source.volume() << " blocks: " << msSince(copyStart) << " ms\n";
+    report("paste", world, viewer, renderDistance, [&] {
+        return world.paste(clipboard, glm::ivec3(0, height / 2, 0));
+    });
+    report("paste, skipping air", world, viewer, renderDistance, [&] {
+        return world.paste(clipboard, glm::ivec3(-half / 2, height / 4, -half / 2), true);
+    });
+
+    // The one-block path relights around every block, so keep this one small
+    int small = std::min(size, 32);
+    BlockBox smallBox(glm::ivec3(-small / 2, 40, -small / 2), glm::ivec3(small / 2 - 1, 40 + small - 1, small / 2 - 1));
+    report("setBlock loop, small box", world, viewer, renderDistance, [&] {
+        EditStats stats;
+        std::set<std::pair<int, int>> chunks;
+        auto start = clock::now();
+        for (int y = smallBox.min.y; y <= smallBox.max.y; ++y) {
+            for (int z = smallBox.min.z; z <= smallBox.max.z; ++z) {
+                for (int x = smallBox.min.x; x <= smallBox.max.x; ++x) {
+                    if (world.getBlock(x, y, z) == BlockType::SAND) continue;
+                    world.setBlock(x, y, z, BlockType::SAND);
+                    ++stats.blocksChanged;
+                    chunks.emplace(World::toChunkCoord(x, Chunk::WIDTH), World::toChunkCoord(z, Chunk::DEPTH));
+                }
+            }
+        }
+        stats.editMs = msSince(start);
+        stats.chunksChanged = chunks.size();
+        return stats;
+    }, true);
+    report("fillBox, same small box", world, viewer, renderDistance, [&] {
+        return world.fillBox(smallBox, BlockType::DIRT);
+    });
+    return 0;
+}
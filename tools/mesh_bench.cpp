@@ -0,0 +1,107 @@
+// Meshing benchmark - times Chunk::buildMesh over a block of generated chunks
+// with and without ambient occlusion, and in both mesh formats. Also times
+// terrain generation on its own (WorldGenerator::generate, one thread).
+// CPU only, no window or GL context needed.
+//
+// usage: mesh_bench [renderDistance] [iterations]
+
+#include "world/World.hpp"
+#include "world/ChunkNeighborhood.hpp"
+#include "world/WorldGenerator.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct Result {
+    double msPerChunk;
+    std::size_t faces;
+    std::size_t bytes; // GPU upload size of all the meshes
+};
+
+Result run(const World& world, const std::vector<Chunk*>& chunks, int iterations, bool ambientOcclusion,
+           MeshFormat format = MeshFormat::VERTICES) {
+    using clock = std::chrono::steady_clock;
+    ChunkMeshData mesh;
+    std::size_t faces = 0;
+    std::size_t bytes = 0;
+
+    auto start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        faces = 0;
+        bytes = 0;
+        for (Chunk* chunk : chunks) {
+            ChunkNeighborhood neighbors(world, chunk->getChunkX(), chunk->getChunkZ());
+            chunk->buildMesh(&neighbors, mesh, ambientOcclusion, format);
+            faces += mesh.faceCount();
+            bytes += mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(unsigned int) +
+                     mesh.faces.size() * sizeof(uint32_t);
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    return { ms / (static_cast<double>(iterations) * chunks.size()), faces, bytes };
+}
+
+// Generate every chunk of the square around (cx, cz) into one chunk, reset
+// in between like the pool does. Returns ms per chunk
+double generate(int cx, int cz, int renderDistance, int iterations) {
+    using clock = std::chrono::steady_clock;
+    WorldGenerator generator(42);
+    Chunk chunk(0, 0);
+
+    auto start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (int z = cz - renderDistance; z <= cz + renderDistance; ++z) {
+            for (int x = cx - renderDistance; x <= cx + renderDistance; ++x) {
+                chunk.reset(x, z);
+                generator.generate(chunk);
+            }
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    int side = 2 * renderDistance + 1;
+    return ms / (static_cast<double>(iterations) * side * side);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int renderDistance = argc > 1 ? std::atoi(argv[1]) : 6;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    // Load a square of chunks around a spot away from the origin
+    World world(42);
+    glm::vec3 center(Chunk::WIDTH * 10.0f, 80.0f, Chunk::DEPTH * 10.0f);
+    world.update(center, renderDistance);
+
+    std::vector<Chunk*> chunks;
+    int cx = World::toChunkCoord(static_cast<int>(center.x), Chunk::WIDTH);
+    int cz = World::toChunkCoord(static_cast<int>(center.z), Chunk::DEPTH);
+    for (int z = cz - renderDistance; z <= cz + renderDistance; ++z) {
+        for (int x = cx - renderDistance; x <= cx + renderDistance; ++x) {
+            if (Chunk* chunk = world.findChunk(x, z)) chunks.push_back(chunk);
+        }
+    }
+
+    // Warm up caches and the mesh buffer's capacity
+    run(world, chunks, 1, true);
+
+    Result flat = run(world, chunks, iterations, false);
+    Result ao = run(world, chunks, iterations, true);
+    Result packed = run(world, chunks, iterations, true, MeshFormat::FACES);
+    double generateMs = generate(cx, cz, renderDistance, iterations);
+
+    std::cout << chunks.size() << " chunks, " << flat.faces << " faces, "
+              << iterations << " iterations\n";
+    std::cout << "  without AO: " << flat.msPerChunk << " ms/chunk\n";
+    std::cout << "  with AO:    " << ao.msPerChunk << " ms/chunk ("
+              << (ao.msPerChunk / flat.msPerChunk - 1.0) * 100.0 << "% slower)\n";
+    std::cout << "  packed faces (with AO): " << packed.msPerChunk << " ms/chunk\n";
+    std::cout << "  bytes/face: vertices " << static_cast<double>(ao.bytes) / ao.faces
+              << ", packed faces " << static_cast<double>(packed.bytes) / packed.faces << "\n";
+    std::cout << "  generation: " << generateMs << " ms/chunk (" << 1000.0 / generateMs
+              << " chunks/s, one thread)\n";
+    return 0;
+}
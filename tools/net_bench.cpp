@@ -0,0 +1,231 @@
+// Chunk streaming benchmark
+//  1. Codec: encodes every chunk around the origin and reports bytes per chunk
+//     at each step (raw, palette + bit-packing, compressed) and encode/decode speed
+//  2. Loopback: runs a ChunkServer on a thread and connects clients to it over
+//     localhost. Each client flies off in its own direction, placing a block now
+//     and then; reports chunks/s and bytes per client. Afterwards every chunk
+//     a client holds is compared with the server's world block for block, and
+//     any difference makes it exit non-zero (registered with ctest, short run)
+//
+// usage: net_bench [clients] [seconds] [fly speed (blocks/s)] [view distance]
+
+#include "net/ChunkClient.hpp"
+#include "net/ChunkServer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+double msSince(clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+}
+
+void codecBench(int viewDistance) {
+    World world(42, WorldMode::HEADLESS);
+    world.update(glm::vec3(0.0f), viewDistance);
+
+    std::vector<const Chunk*> chunks;
+    world.forEachChunk([&](Chunk& chunk) { chunks.push_back(&chunk); });
+
+    CodecStats stats;
+    std::vector<std::vector<uint8_t>> payloads(chunks.size());
+    auto start = clock::now();
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        ChunkCodec::encodeChunk(*chunks[i], payloads[i], &stats);
+    }
+    double encodeMs = msSince(start);
+
+    start = clock::now();
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        std::shared_ptr<Chunk> decoded = ChunkCodec::decodeChunk(payloads[i].data(), payloads[i].size());
+        if (!decoded) {
+            ++mismatches;
+            continue;
+        }
+        for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+            const BlockType* a = chunks[i]->getSectionBlocks(s);
+            const BlockType* b = decoded->getSectionBlocks(s);
+            if (!std::equal(a, a + Chunk::SECTION_VOLUME, b)) {
+                ++mismatches;
+                break;
+            }
+        }
+    }
+    double decodeMs = msSince(start);
+
+    double n = static_cast<double>(stats.chunks);
+    std::cout << "codec: " << stats.chunks << " chunks\n";
+    std::cout << "  raw        " << stats.rawBytes / n << " bytes/chunk\n";
+    std::cout << "  packed     " << stats.packedBytes / n << " bytes/chunk\n";
+    std::cout << "  compressed " << stats.compressedBytes / n << " bytes/chunk ("
+              << stats.rawBytes / static_cast<double>(stats.compressedBytes) << "x smaller than raw)\n";
+    std::cout << "  encode " << encodeMs * 1000.0 / n << " us/chunk, decode "
+              << decodeMs * 1000.0 / n << " us/chunk, " << mismatches << " mismatches\n";
+}
+
+// Chunks the client holds that differ from the server's, or that the server
+// doesn't have loaded. Both worlds must be quiet (server stopped, client drained)
+std::size_t compareWorlds(const World& server, const World& client, std::size_t& compared) {
+    std::size_t mismatches = 0;
+    compared = 0;
+    client.forEachChunk([&](const Chunk& chunk) {
+        ++compared;
+        const Chunk* truth = server.findChunk(chunk.getChunkX(), chunk.getChunkZ());
+        if (!truth) {
+            std::cerr << "  chunk (" << chunk.getChunkX() << ", " << chunk.getChunkZ()
+                      << ") is held by a client but not loaded on the server\n";
+            ++mismatches;
+            return;
+        }
+        for (int s = 0; s < Chunk::SECTION_COUNT; ++s) {
+            const BlockType* a = truth->getSectionBlocks(s);
+            const BlockType* b = chunk.getSectionBlocks(s);
+            if (!std::equal(a, a + Chunk::SECTION_VOLUME, b)) {
+                std::cerr << "  chunk (" << chunk.getChunkX() << ", " << chunk.getChunkZ() << ") section " << s
+                          << " differs from the server\n";
+                ++mismatches;
+                break;
+            }
+        }
+    });
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int clientCount = argc > 1 ? std::atoi(argv[1]) : 4;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 10.0;
+    float flySpeed = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 20.0f;
+    int viewDistance = argc > 4 ? std::atoi(argv[4]) : 6;
+
+    codecBench(viewDistance);
+
+    // Server on its own thread at the real tick rate
+    Simulation sim(42, viewDistance);
+    ChunkServer server(sim);
+    if (!server.listen(0)) return 1;
+    uint16_t port = server.getPort();
+
+    std::atomic<bool> running{true};
+    std::thread serverThread([&] {
+        const auto tickLength = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(Simulation::TICK_DT));
+        auto nextTick = clock::now();
+        while (running) {
+            server.tick();
+            nextTick = std::max(nextTick + tickLength, clock::now());
+            std::this_thread::sleep_until(nextTick);
+        }
+    });
+
+    std::vector<std::unique_ptr<ChunkClient>> clients;
+    std::vector<glm::vec3> positions, directions;
+    for (int i = 0; i < clientCount; ++i) {
+        auto client = std::make_unique<ChunkClient>();
+        if (!client->connect("127.0.0.1", port, viewDistance)) break;
+        float angle = 6.2831853f * i / clientCount;
+        directions.emplace_back(std::cos(angle), 0.0f, std::sin(angle));
+        positions.emplace_back(0.0f);
+        clients.push_back(std::move(client));
+    }
+
+    // Clients all live on this thread, polled at 60 Hz
+    const int fullView = (2 * viewDistance + 1) * (2 * viewDistance + 1);
+    std::vector<double> firstFullView(clients.size(), -1.0);
+    auto start = clock::now();
+    auto frame = start;
+    int frameIndex = 0;
+    while (msSince(start) < seconds * 1000.0) {
+        double t = msSince(start);
+        for (std::size_t i = 0; i < clients.size(); ++i) {
+            ChunkClient& client = *clients[i];
+            client.poll();
+            if (!client.isReady()) continue;
+
+            if (positions[i] == glm::vec3(0.0f)) positions[i] = client.getSpawn() + glm::vec3(0.0f, 20.0f, 0.0f);
+            // Sit still until the first full view has arrived, then fly
+            if (firstFullView[i] < 0.0) {
+                if (static_cast<int>(client.getWorld().getChunkCount()) >= fullView) firstFullView[i] = t;
+            } else {
+                positions[i] += directions[i] * (flySpeed / 60.0f);
+            }
+            client.setPosition(positions[i]);
+
+            // A block edit every half second, so deltas are part of the traffic
+            if (frameIndex % 30 == static_cast<int>(i % 30)) {
+                glm::ivec3 p(glm::floor(positions[i]));
+                client.requestBlockEdit(p.x, p.y - 10, p.z, BlockType::GLOWSTONE);
+            }
+        }
+        ++frameIndex;
+        frame += std::chrono::microseconds(16667);
+        std::this_thread::sleep_until(frame);
+    }
+
+    running = false;
+    serverThread.join();
+
+    // Let everything the server sent arrive: its queues go out, then the
+    // clients read until nothing new has come in for a while
+    auto received = [&] {
+        uint64_t n = 0;
+        for (const auto& client : clients) {
+            const ClientStats& s = client->getStats();
+            n += s.chunksReceived + s.deltasReceived + s.unloadsReceived;
+        }
+        return n;
+    };
+    auto quietSince = clock::now();
+    uint64_t lastReceived = received();
+    for (auto drainStart = clock::now(); msSince(drainStart) < 5000.0;) {
+        bool flushed = server.flush();
+        for (auto& client : clients) client->poll();
+        if (received() != lastReceived || !flushed) {
+            lastReceived = received();
+            quietSince = clock::now();
+        } else if (msSince(quietSince) > 100.0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::cout << "loopback: " << clients.size() << " clients, " << seconds << " s, flying at "
+              << flySpeed << " blocks/s, view distance " << viewDistance << "\n";
+    for (std::size_t i = 0; i < clients.size(); ++i) {
+        const ClientStats& s = clients[i]->getStats();
+        std::cout << "  client " << i << ": " << s.chunksReceived << " chunks ("
+                  << s.chunksReceived / seconds << "/s), "
+                  << (s.chunksReceived ? s.chunkBytes / s.chunksReceived : 0) << " bytes/chunk, "
+                  << s.deltasReceived << " deltas, " << s.unloadsReceived << " unloads, decode "
+                  << (s.chunksReceived ? s.decodeMs / s.chunksReceived : 0.0) << " ms/chunk, first full view ";
+        if (firstFullView[i] >= 0.0) std::cout << firstFullView[i] << " ms\n";
+        else std::cout << "never\n";
+    }
+    std::cout << "  server sent " << server.getChunksSent() << " chunks, encoded "
+              << server.getCodecStats().chunks << "\n";
+
+    // What each client ended up with has to be the server's world, after
+    // unloads and resends, edits and the deltas block ticks produced
+    bool replicated = !clients.empty();
+    for (std::size_t i = 0; i < clients.size(); ++i) {
+        std::size_t compared = 0;
+        std::size_t mismatches = compareWorlds(sim.getWorld(), clients[i]->getWorld(), compared);
+        std::cout << "  client " << i << ": " << compared << " chunks compared with the server, " << mismatches
+                  << " mismatches\n";
+        if (mismatches > 0 || compared == 0) replicated = false;
+    }
+    if (!replicated) {
+        std::cerr << "clients don't match the server\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,250 @@
+// Rendering benchmark - draws a fixed scene (or a recorded camera path) into
+// an offscreen framebuffer and reports GPU time per pass from timer queries,
+// plus draw calls, triangles and GL state changes per frame (and the binds
+// the GLStateCache skipped).
+// Needs no display: the default EGL surfaceless context runs on Mesa's
+// llvmpipe, so render path changes can be compared on a headless machine.
+//
+// usage: render_bench [--frames N] [--warmup N] [--width W] [--height H]
+//                     [--distance D] [--seed SEED] [--context egl|window]
+//                     [--path FILE] [--format vertices|faces] [--sync]
+//
+// --context window uses a hidden GLFW window instead (needs a display)
+// --sync also waits (glFinish) after every pass and reports wall time per
+//   pass. Software rasterizers like llvmpipe draw when the commands are
+//   flushed rather than between the timer queries, so their query times
+//   are close to zero - use this there
+// --path replays a file from minecraft_cpp --record, one frame per pose
+// --format picks the chunk mesh layout (see MeshFormat)
+
+#include "core/Camera.hpp"
+#include "core/Framebuffer.hpp"
+#include "core/GpuTimer.hpp"
+#include "core/MemoryTracker.hpp"
+#include "core/OffscreenContext.hpp"
+#include "core/Renderer.hpp"
+#include "core/Replay.hpp"
+#include "core/Stats.hpp"
+#include "core/Window.hpp"
+#include "core/WorldRenderer.hpp"
+#include "world/World.hpp"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+struct Options {
+    int frames = 300;
+    int warmup = 30;
+    int width = 1280;
+    int height = 720;
+    int distance = 6;
+    int seed = 42;
+    std::string context = "egl";
+    std::string path;
+    MeshFormat format = MeshFormat::VERTICES;
+    bool sync = false;
+};
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!std::strcmp(arg, "--sync")) { opt.sync = true; continue; }
+        if (!value) return false;
+        if (!std::strcmp(arg, "--frames")) opt.frames = std::atoi(value);
+        else if (!std::strcmp(arg, "--warmup")) opt.warmup = std::atoi(value);
+        else if (!std::strcmp(arg, "--width")) opt.width = std::atoi(value);
+        else if (!std::strcmp(arg, "--height")) opt.height = std::atoi(value);
+        else if (!std::strcmp(arg, "--distance")) opt.distance = std::atoi(value);
+        else if (!std::strcmp(arg, "--seed")) opt.seed = std::atoi(value);
+        else if (!std::strcmp(arg, "--context")) opt.context = value;
+        else if (!std::strcmp(arg, "--path")) opt.path = value;
+        else if (!std::strcmp(arg, "--format") && !std::strcmp(value, "vertices")) opt.format = MeshFormat::VERTICES;
+        else if (!std::strcmp(arg, "--format") && !std::strcmp(value, "faces")) opt.format = MeshFormat::FACES;
+        else return false;
+        ++i;
+    }
+    return opt.context == "egl" || opt.context == "window";
+}
+
+void printStats(const char* name, const SampleStats& stats) {
+    std::cout << "  " << name << ": mean " << stats.mean()
+              << "  p50 " << stats.percentile(50.0)
+              << "  p95 " << stats.percentile(95.0)
+              << "  max " << stats.max() << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        std::cerr << "usage: render_bench [--frames N] [--warmup N] [--width W] [--height H]\n"
+                     "                    [--distance D] [--seed SEED] [--context egl|window] [--path FILE]\n"
+                     "                    [--format vertices|faces] [--sync]\n";
+        return 1;
+    }
+
+    CameraPath path;
+    if (!opt.path.empty()) {
+        if (!path.load(opt.path)) return 1;
+        opt.seed = path.seed;
+        opt.distance = path.renderDistance;
+        opt.frames = static_cast<int>(path.frames.size());
+    }
+
+    // Either kind of context works the same from here on: everything is
+    // drawn into our own framebuffer, nothing is ever presented
+    std::unique_ptr<OffscreenContext> offscreen;
+    std::unique_ptr<Window> window;
+    GLADloadproc loader;
+    if (opt.context == "egl") {
+        offscreen = std::make_unique<OffscreenContext>();
+        if (!offscreen->create()) return 1;
+        loader = OffscreenContext::getLoader();
+    } else {
+        window = std::make_unique<Window>(opt.width, opt.height, "render_bench", WindowMode::HIDDEN);
+        if (!window->hasContext()) return 1;
+        glfwSwapInterval(0);
+        loader = (GLADloadproc)glfwGetProcAddress;
+    }
+
+    Renderer renderer;
+    renderer.init(opt.width, opt.height, loader);
+    if (!renderer.getShaderProgram()) return 1;
+
+    Framebuffer framebuffer;
+    if (!framebuffer.create(opt.width, opt.height)) return 1;
+    framebuffer.bind();
+    glClearColor(0.5f, 0.7f, 1.0f, 1.0f);
+
+    float aspect = static_cast<float>(opt.width) / opt.height;
+    renderer.setProjectionMatrix(glm::perspective(glm::radians(45.0f), aspect, 0.1f, 1000.0f));
+
+    // Fixed scene: above the terrain near the origin, looking down across it
+    Camera camera(glm::vec3(8.0f, 90.0f, 8.0f));
+    camera.setOrientation(-45.0f, -25.0f);
+
+    World world(opt.seed);
+    world.setMeshFormat(opt.format);
+    WorldRenderer worldRenderer;
+    GpuTimer clearTimer, uploadTimer, drawTimer;
+    SampleStats clearMs, uploadMs, drawMs; // --sync only
+    SampleStats cpuMs, drawCalls, triangles, stateChanges, skippedBinds, uploadBytes;
+
+    using clock = std::chrono::steady_clock;
+    clock::time_point runStart;
+    uint64_t glObjectsBefore = 0;
+
+    // GL objects ever created, streaming shouldn't add any once it's warmed up
+    auto glObjectsCreated = [] {
+        MemorySnapshot memory = MemoryTracker::snapshot();
+        return memory[MemoryCategory::GPU_BUFFERS].allocations + memory[MemoryCategory::GL_OBJECTS].allocations;
+    };
+
+    // Wall time of one pass, finished on the GPU
+    auto syncedMs = [](clock::time_point start) {
+        glFinish();
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+
+    for (int frame = -opt.warmup; frame < opt.frames; ++frame) {
+        bool measured = frame >= 0;
+        if (frame == 0) {
+            glFinish(); // keep warmup work out of the wall time
+            runStart = clock::now();
+            glObjectsBefore = glObjectsCreated();
+        }
+
+        if (!path.frames.empty()) {
+            const RecordedFrame& pose = path.frames[frame < 0 ? 0 : frame];
+            camera.setPosition(pose.position);
+            camera.setOrientation(pose.yaw, pose.pitch);
+            if (measured) {
+                for (const RecordedEdit& e : pose.edits) world.setBlock(e.x, e.y, e.z, e.type);
+                world.tick(); // one tick per recorded frame, like minecraft_cpp --replay
+            }
+        }
+        world.update(camera.getPosition(), opt.distance);
+
+        auto cpuStart = clock::now();
+        worldRenderer.resetStats();
+
+        bool sync = measured && opt.sync;
+        if (sync) glFinish();
+
+        auto passStart = clock::now();
+        if (measured) clearTimer.begin();
+        renderer.clear();
+        if (measured) clearTimer.end();
+        if (sync) clearMs.add(syncedMs(passStart));
+
+        renderer.setViewMatrix(camera.getViewMatrix());
+
+        passStart = clock::now();
+        if (measured) uploadTimer.begin();
+        worldRenderer.uploadMeshes(world, renderer, camera.getPosition());
+        if (measured) uploadTimer.end();
+        if (sync) uploadMs.add(syncedMs(passStart));
+
+        passStart = clock::now();
+        if (measured) drawTimer.begin();
+        worldRenderer.draw(renderer, camera.getPosition());
+        if (measured) drawTimer.end();
+        if (sync) drawMs.add(syncedMs(passStart));
+
+        if (!measured) continue;
+        cpuMs.add(std::chrono::duration<double, std::milli>(clock::now() - cpuStart).count());
+        const RenderStats& stats = worldRenderer.getStats();
+        drawCalls.add(static_cast<double>(stats.drawCalls));
+        triangles.add(static_cast<double>(stats.triangles));
+        stateChanges.add(static_cast<double>(stats.stateChanges));
+        skippedBinds.add(static_cast<double>(stats.redundantStateChanges));
+        uploadBytes.add(static_cast<double>(stats.uploadBytes));
+    }
+
+    glFinish();
+    double wallMs = std::chrono::duration<double, std::milli>(clock::now() - runStart).count();
+    clearTimer.finish();
+    uploadTimer.finish();
+    drawTimer.finish();
+
+    std::cout << "renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")\n";
+    std::cout << opt.frames << " frames at " << opt.width << "x" << opt.height << ", distance " << opt.distance
+              << ", seed " << opt.seed << ", " << world.getChunkCount() << " chunks";
+    std::cout << (opt.format == MeshFormat::FACES ? ", packed faces" : ", vertices");
+    if (!opt.path.empty()) std::cout << ", path " << opt.path;
+    std::cout << "\n";
+    std::cout << "GPU ms per pass\n";
+    printStats("clear", clearTimer.getSamples());
+    printStats("upload", uploadTimer.getSamples());
+    printStats("draw", drawTimer.getSamples());
+    if (opt.sync) {
+        std::cout << "wall ms per pass (synced)\n";
+        printStats("clear", clearMs);
+        printStats("upload", uploadMs);
+        printStats("draw", drawMs);
+    }
+    std::cout << (opt.sync ? "CPU ms per frame (synced)\n" : "CPU ms to submit a frame\n");
+    printStats("submit", cpuMs);
+    std::cout << "  wall ms/frame (world update + submit + GPU): "
+              << (opt.frames > 0 ? wallMs / opt.frames : 0.0) << "\n";
+    std::cout << "per frame\n";
+    printStats("draw calls", drawCalls);
+    printStats("triangles", triangles);
+    printStats("state changes", stateChanges);
+    printStats("skipped binds", skippedBinds);
+    printStats("upload bytes", uploadBytes);
+    std::cout << "  GL objects created while measuring: " << glObjectsCreated() - glObjectsBefore << "\n";
+    std::cout << "memory\n";
+    MemoryTracker::snapshot().print(std::cout);
+    return 0;
+}
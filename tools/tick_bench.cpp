@@ -0,0 +1,89 @@
+// Block tick benchmark - what ticking costs with nothing going on (random
+// ticks over every loaded section), and with water: one source pouring out,
+// a big lake dumped onto a platform spreading out and settling, then the lake
+// taken away and its flow drying up. Every tick is followed by the update()
+// that remeshes what it changed, like a frame would.
+// CPU only, no window or GL context needed.
+//
+// usage: tick_bench [renderDistance]
+
+#include "world/World.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+// Tick until the water is quiet again (or maxTicks), then print what it took
+void settle(const char* name, World& world, const glm::vec3& viewer, int renderDistance, int maxTicks) {
+    WorldStats before = world.getStats();
+    std::size_t peakUpdates = 0;
+    double peakTickMs = 0.0, peakUpdateMs = 0.0;
+    int ticks = 0;
+    while (ticks < maxTicks &&
+           (ticks == 0 || world.getBlockTicks().getPendingCount() > 0 || world.getPendingLightUpdates() > 0)) {
+        auto start = clock::now();
+        world.tick();
+        auto ticked = clock::now();
+        world.update(viewer, renderDistance);
+        peakTickMs = std::max(peakTickMs, std::chrono::duration<double, std::milli>(ticked - start).count());
+        peakUpdateMs = std::max(peakUpdateMs, std::chrono::duration<double, std::milli>(clock::now() - ticked).count());
+        peakUpdates = std::max(peakUpdates, world.getBlockTicks().getLastUpdates());
+        ++ticks;
+    }
+
+    const WorldStats& after = world.getStats();
+    double tickMs = after.tickMs - before.tickMs;
+    double meshMs = after.meshMs - before.meshMs;
+    std::cout << name << ": " << ticks << " ticks" << (ticks == maxTicks ? " (still going)" : "") << "\n"
+              << "  " << after.blockUpdates - before.blockUpdates << " updates (peak " << peakUpdates << "/tick), "
+              << after.tickChanges - before.tickChanges << " blocks changed\n"
+              << "  tick " << tickMs << " ms (" << tickMs / ticks << " ms/tick), remesh " << meshMs << " ms ("
+              << after.meshesBuilt - before.meshesBuilt << " chunks)\n"
+              << "  worst tick " << peakTickMs << " ms (light included), worst update " << peakUpdateMs << " ms\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int renderDistance = argc > 1 ? std::atoi(argv[1]) : 8;
+
+    World world(42);
+    glm::vec3 viewer(8.0f, 80.0f, 8.0f);
+    world.update(viewer, renderDistance);
+    std::cout << world.getChunkCount() << " chunks loaded, distance " << renderDistance << "\n";
+
+    // Nothing scheduled, only random ticks
+    const int idleTicks = 600;
+    WorldStats before = world.getStats();
+    for (int i = 0; i < idleTicks; ++i) world.tick();
+    const WorldStats& idle = world.getStats();
+    std::cout << "idle: " << (idle.tickMs - before.tickMs) / idleTicks << " ms/tick, "
+              << static_cast<double>(idle.randomTickHits - before.randomTickHits) / idleTicks
+              << " random ticks hit grass/tick, " << idle.tickChanges - before.tickChanges << " blocks changed\n";
+    world.update(viewer, renderDistance);
+
+    // A platform high above the terrain, open on all sides
+    const int half = 64;
+    const int floorY = 150;
+    world.fillBox(BlockBox(glm::ivec3(-half, floorY, -half), glm::ivec3(half - 1, floorY, half - 1)), BlockType::STONE);
+    world.update(viewer, renderDistance);
+
+    world.setBlock(0, floorY + 1, 0, BlockType::WATER);
+    settle("one source", world, viewer, renderDistance, 2000);
+    world.setBlock(0, floorY + 1, 0, BlockType::AIR);
+    settle("one source, dried up", world, viewer, renderDistance, 2000);
+
+    // The lake's inside never gets an update, only its shore does. Its
+    // edge reaches the platform's, so some of it pours over the side too
+    BlockBox lake(glm::ivec3(-half + 4, floorY + 1, -half + 4), glm::ivec3(half - 5, floorY + 4, half - 5));
+    EditStats edit = world.fillBox(lake, BlockType::WATER);
+    std::cout << "lake of " << edit.blocksChanged << " source blocks\n";
+    settle("lake spreading", world, viewer, renderDistance, 5000);
+    world.fillBox(lake, BlockType::AIR);
+    settle("lake gone, drying up", world, viewer, renderDistance, 5000);
+    return 0;
+}